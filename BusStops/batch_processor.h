@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bus_manager.h"
+#include "query.h"
+#include "query_reader.h"
+#include "response_writer.h"
+#include "thread_pool.h"
+
+// Вывод ответов в строку, подходящий для PrintResponse
+struct StringResponseOutput {
+    std::string& text;
+
+    StringResponseOutput& operator<<(std::string_view value) {
+        text.append(value);
+        return *this;
+    }
+
+    StringResponseOutput& operator<<(char value) {
+        text.push_back(value);
+        return *this;
+    }
+};
+
+// Выводит ответ на запрос чтения и перевод строки после него.
+// NEW_BUS ничего не выводит
+template <typename Output>
+void PrintQueryResponse(Output& out, const BusManager& manager, const Query& query) {
+    switch (query.type) {
+        case QueryType::NewBus:
+            return;
+        case QueryType::BusesForStop:
+            PrintResponse(out, manager.GetBusesForStop(query.stop));
+            break;
+        case QueryType::StopsForBus:
+            PrintResponse(out, manager.GetStopsForBus(query.bus));
+            break;
+        case QueryType::AllBuses:
+            PrintResponse(out, manager.GetAllBuses());
+            break;
+        case QueryType::Route:
+            PrintResponse(out, manager.GetRoute(query.stop, query.destination));
+            break;
+    }
+    out << '\n';
+}
+
+// Количество запросов, которое один поток обрабатывает за раз
+inline constexpr size_t kBatchChunkSize = 256;
+
+// Выполняет запросы с тем же результатом, что и последовательная обработка.
+// NEW_BUS - барьеры: запросы чтения между соседними NEW_BUS не меняют данные,
+// поэтому выполняются на потоках пула частями по chunk_size запросов.
+// Ответы каждой части собираются в отдельную строку и выводятся в исходном порядке
+inline void ProcessQueriesInBatch(BusManager& manager, const std::vector<Query>& queries,
+                                  ResponseWriter& writer, ThreadPool& pool,
+                                  size_t chunk_size = kBatchChunkSize) {
+    std::vector<std::string> chunk_outputs;
+
+    size_t begin = 0;
+    while (begin < queries.size()) {
+        if (queries[begin].type == QueryType::NewBus) {
+            manager.AddBus(queries[begin].bus, queries[begin].stops);
+            ++begin;
+            continue;
+        }
+
+        size_t end = begin;
+        while (end < queries.size() && queries[end].type != QueryType::NewBus) {
+            ++end;
+        }
+
+        if (end - begin <= chunk_size) {
+            // На короткую группу не стоит будить пул
+            for (size_t i = begin; i < end; ++i) {
+                PrintQueryResponse(writer, manager, queries[i]);
+            }
+        } else {
+            const size_t chunk_count = (end - begin + chunk_size - 1) / chunk_size;
+            if (chunk_outputs.size() < chunk_count) {
+                chunk_outputs.resize(chunk_count);
+            }
+
+            const BusManager& reader = manager;
+            pool.Run(chunk_count, [&, begin, end](size_t chunk) {
+                std::string& text = chunk_outputs[chunk];
+                text.clear();
+                StringResponseOutput out{text};
+
+                const size_t chunk_begin = begin + chunk * chunk_size;
+                const size_t chunk_end = std::min(end, chunk_begin + chunk_size);
+                for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                    PrintQueryResponse(out, reader, queries[i]);
+                }
+            });
+
+            for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+                writer << chunk_outputs[chunk];
+            }
+        }
+
+        begin = end;
+    }
+}
+
+// Больше запросов заранее не резервируем: count приходит из ввода и может быть
+// сколь угодно большим, дальше вектор растёт по мере чтения
+inline constexpr size_t kMaxReservedQueries = 1 << 16;
+
+// Читает count запросов целиком, затем выполняет их через ProcessQueriesInBatch.
+// Выбрасывает std::invalid_argument при отрицательном count
+inline void ProcessQueriesInBatch(QueryReader& reader, int count, ResponseWriter& writer, ThreadPool& pool) {
+    if (count < 0) {
+        throw std::invalid_argument("negative query count " + std::to_string(count));
+    }
+
+    std::vector<Query> queries;
+    queries.reserve(std::min(static_cast<size_t>(count), kMaxReservedQueries));
+    Query query;
+    while (queries.size() < static_cast<size_t>(count) && reader.Read(query)) {
+        queries.push_back(std::move(query));
+    }
+
+    BusManager manager;
+    ProcessQueriesInBatch(manager, queries, writer, pool);
+}
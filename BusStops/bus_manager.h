@@ -0,0 +1,717 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bus_snapshot.h"
+#include "route_search.h"
+#include "string_interner.h"
+
+// Последовательность имён, заданная идентификаторами из хранилища BusManager.
+// Не владеет данными и действительна до следующего изменения менеджера
+class NameSpan {
+public:
+    using Id = StringInterner::Id;
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        Iterator() = default;
+
+        Iterator(const Id* id, const StringInterner* names) noexcept
+        : id_(id)
+        , names_(names) {
+        }
+
+        [[nodiscard]] bool operator==(const Iterator& right) const noexcept {
+            return id_ == right.id_;
+        }
+
+        [[nodiscard]] bool operator!=(const Iterator& right) const noexcept {
+            return !(*this == right);
+        }
+
+        Iterator& operator++() noexcept {
+            ++id_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            auto old_value(*this);
+            ++(*this);
+            return old_value;
+        }
+
+        [[nodiscard]] std::string_view operator*() const {
+            return names_->GetName(*id_);
+        }
+
+    private:
+        const Id* id_ = nullptr;
+        const StringInterner* names_ = nullptr;
+    };
+
+public:
+    NameSpan() = default;
+
+    NameSpan(const std::vector<Id>& ids, const StringInterner& names) noexcept
+    : begin_(ids.data())
+    , end_(ids.data() + ids.size())
+    , names_(&names) {
+    }
+
+    [[nodiscard]] Iterator begin() const noexcept {
+        return {begin_, names_};
+    }
+
+    [[nodiscard]] Iterator end() const noexcept {
+        return {end_, names_};
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return end_ - begin_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return begin_ == end_;
+    }
+
+private:
+    const Id* begin_ = nullptr;
+    const Id* end_ = nullptr;
+    const StringInterner* names_ = nullptr;
+};
+
+// Последовательность пар (имя, список имён): ключи берутся из keys, а списки -
+// из lists по идентификатору ключа. Так без копирования описываются и остановки
+// маршрута с автобусами через каждую из них, и все автобусы с их маршрутами.
+// Действительна до следующего изменения менеджера
+class NameListsView {
+public:
+    using Id = StringInterner::Id;
+    using value_type = std::pair<std::string_view, NameSpan>;
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = NameListsView::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+
+        Iterator() = default;
+
+        Iterator(const Id* key, const StringInterner* key_names,
+                 const std::vector<std::vector<Id>>* lists, const StringInterner* list_names) noexcept
+        : key_(key)
+        , key_names_(key_names)
+        , lists_(lists)
+        , list_names_(list_names) {
+        }
+
+        [[nodiscard]] bool operator==(const Iterator& right) const noexcept {
+            return key_ == right.key_;
+        }
+
+        [[nodiscard]] bool operator!=(const Iterator& right) const noexcept {
+            return !(*this == right);
+        }
+
+        Iterator& operator++() noexcept {
+            ++key_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            auto old_value(*this);
+            ++(*this);
+            return old_value;
+        }
+
+        [[nodiscard]] value_type operator*() const {
+            return {key_names_->GetName(*key_), NameSpan((*lists_)[*key_], *list_names_)};
+        }
+
+    private:
+        const Id* key_ = nullptr;
+        const StringInterner* key_names_ = nullptr;
+        const std::vector<std::vector<Id>>* lists_ = nullptr;
+        const StringInterner* list_names_ = nullptr;
+    };
+
+public:
+    NameListsView() = default;
+
+    NameListsView(const std::vector<Id>& keys, const StringInterner& key_names,
+                  const std::vector<std::vector<Id>>& lists, const StringInterner& list_names) noexcept
+    : begin_(keys.data())
+    , end_(keys.data() + keys.size())
+    , key_names_(&key_names)
+    , lists_(&lists)
+    , list_names_(&list_names) {
+    }
+
+    [[nodiscard]] Iterator begin() const noexcept {
+        return {begin_, key_names_, lists_, list_names_};
+    }
+
+    [[nodiscard]] Iterator end() const noexcept {
+        return {end_, key_names_, lists_, list_names_};
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return end_ - begin_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return begin_ == end_;
+    }
+
+private:
+    const Id* begin_ = nullptr;
+    const Id* end_ = nullptr;
+    const StringInterner* key_names_ = nullptr;
+    const std::vector<std::vector<Id>>* lists_ = nullptr;
+    const StringInterner* list_names_ = nullptr;
+};
+
+struct BusesForStopResponse {
+    NameSpan buses;
+};
+
+// Выводит ответ в out, поддерживающий << для string_view и char: в std::ostream
+// или в ResponseWriter. Соседние ответы разделяет вызывающий код
+template <typename Output>
+void PrintResponse(Output& out, const BusesForStopResponse& r) {
+    using namespace std::literals;
+
+    if (r.buses.empty()) {
+        out << "No stop"sv;
+    } else {
+        bool isFirst = true;
+        for (std::string_view bus : r.buses) {
+            // avoid extra space at the end of the output
+            if(isFirst) {
+                out << bus;
+                isFirst = false;
+                continue;
+            }
+            out << ' ' << bus;
+        }
+    }
+}
+
+inline std::ostream& operator<<(std::ostream& os, const BusesForStopResponse& r) {
+    PrintResponse(os, r);
+    return os;
+}
+
+struct StopsForBusResponse {
+    std::string_view bus;
+    // Остановки маршрута и автобусы, проходящие через каждую из них
+    NameListsView stops_to_buses;
+};
+
+template <typename Output>
+void PrintResponse(Output& out, const StopsForBusResponse& r) {
+    using namespace std::literals;
+
+    if (r.stops_to_buses.empty()) {
+        out << "No bus"sv;
+    } else {
+        bool isFirstLine = true;
+
+        for (const auto& [stop, buses] : r.stops_to_buses) {
+            if (isFirstLine) {
+                isFirstLine = false;
+            } else {
+                out << '\n';
+            }
+
+            out << "Stop "sv << stop << ": "sv;
+            if (buses.size() == 1) {
+                out << "no interchange"sv;
+            } else {
+                bool isFirstBus = true;
+                for (std::string_view other_bus : buses) {
+                    if (r.bus != other_bus) {
+                        if(isFirstBus) {
+                            out << other_bus;
+                            isFirstBus = false;
+                            continue;
+                        }
+                        out << ' ' << other_bus;
+                    }
+                }
+            }
+        }
+    }
+}
+
+inline std::ostream& operator<<(std::ostream& os, const StopsForBusResponse& r) {
+    PrintResponse(os, r);
+    return os;
+}
+
+struct AllBusesResponse {
+    // Автобусы в порядке имён и остановки каждого маршрута
+    NameListsView buses_to_stops;
+};
+
+template <typename Output>
+void PrintResponse(Output& out, const AllBusesResponse& r) {
+    using namespace std::literals;
+
+    if (r.buses_to_stops.empty()) {
+        out << "No buses"sv;
+    } else {
+        bool isFirstLine = true;
+        for (const auto& bus_item : r.buses_to_stops) {
+            if (isFirstLine) {
+                isFirstLine = false;
+            } else {
+                out << '\n';
+            }
+
+            out << "Bus "sv << bus_item.first << ": "sv;
+            bool isFirstStop = true;
+            for (std::string_view stop : bus_item.second) {
+                if(isFirstStop) {
+                    out << stop;
+                    isFirstStop = false;
+                    continue;
+                }
+                out << ' ' << stop;
+            }
+        }
+    }
+}
+
+inline std::ostream& operator<<(std::ostream& os, const AllBusesResponse& r) {
+    PrintResponse(os, r);
+    return os;
+}
+
+struct RouteResponse {
+    // Пустые, если остановки нет или через неё не проходит ни один автобус
+    std::string_view from;
+    std::string_view to;
+    bool found = false;
+    // Автобус и остановка, где с него сойти. Пусто, если from и to совпадают
+    std::vector<std::pair<std::string_view, std::string_view>> legs;
+};
+
+template <typename Output>
+void PrintResponse(Output& out, const RouteResponse& r) {
+    using namespace std::literals;
+
+    if (r.from.empty() || r.to.empty()) {
+        out << "No stop"sv;
+    } else if (!r.found) {
+        out << "No route"sv;
+    } else if (r.legs.empty()) {
+        out << "No bus needed"sv;
+    } else {
+        out << "Transfers "sv << std::to_string(r.legs.size() - 1) << ": "sv;
+        bool isFirstLeg = true;
+        for (const auto& [bus, stop] : r.legs) {
+            if (isFirstLeg) {
+                isFirstLeg = false;
+            } else {
+                out << ", "sv;
+            }
+            out << bus << " to "sv << stop;
+        }
+    }
+}
+
+inline std::ostream& operator<<(std::ostream& os, const RouteResponse& r) {
+    PrintResponse(os, r);
+    return os;
+}
+
+class BusManager {
+public:
+    using StopId = StringInterner::Id;
+    using BusId = StringInterner::Id;
+
+    // Добавляет автобус или, если он уже есть, заменяет его маршрут как UpdateBus
+    void AddBus(std::string_view bus, const std::vector<std::string>& stops) {
+        const BusId bus_id = bus_names_.Intern(bus);
+        if (bus_id == bus_to_stops_.size()) {
+            bus_to_stops_.emplace_back();
+        }
+        if (!IsActive(bus_id)) {
+            InsertIntoSortedBuses(bus_id);
+        }
+
+        SetRoute(bus_id, stops);
+    }
+
+    // Заменяет маршрут существующего автобуса. Обратный индекс меняется только
+    // для остановок, которые появились в маршруте или пропали из него; у остальных
+    // остановок автобус сохраняет своё место в списке.
+    // Возвращает false, если такого автобуса нет
+    bool UpdateBus(std::string_view bus, const std::vector<std::string>& stops) {
+        const auto bus_id = bus_names_.Find(bus);
+        if (!bus_id || !IsActive(*bus_id)) {
+            return false;
+        }
+
+        SetRoute(*bus_id, stops);
+        return true;
+    }
+
+    // Удаляет автобус и его записи в обратном индексе.
+    // Остановки, через которые не проходит ни один автобус, считаются отсутствующими.
+    // Возвращает false, если такого автобуса нет
+    bool RemoveBus(std::string_view bus) {
+        const auto bus_id = bus_names_.Find(bus);
+        if (!bus_id || !IsActive(*bus_id)) {
+            return false;
+        }
+
+        for (StopId stop_id : GetUniqueStops(bus_to_stops_[*bus_id])) {
+            EraseFromIndex(stop_id, *bus_id);
+        }
+        bus_to_stops_[*bus_id].clear();
+        sorted_buses_.erase(FindInSortedBuses(bus_names_.GetName(*bus_id)));
+        transfer_table_ = {};
+
+        return true;
+    }
+
+    // Ответы ссылаются на данные менеджера и действительны до следующего изменения
+    // через AddBus, UpdateBus или RemoveBus
+    BusesForStopResponse GetBusesForStop(std::string_view stop) const {
+        BusesForStopResponse response;
+
+        const auto stop_id = stop_names_.Find(stop);
+        if (!stop_id) {
+            return response;
+        }
+
+        response.buses = NameSpan(stop_to_buses_[*stop_id], bus_names_);
+
+        return response;
+    }
+
+    StopsForBusResponse GetStopsForBus(std::string_view bus) const {
+        StopsForBusResponse response;
+
+        const auto bus_id = bus_names_.Find(bus);
+        if (!bus_id) {
+            return response;
+        }
+
+        response.bus = bus_names_.GetName(*bus_id);
+        response.stops_to_buses = NameListsView(bus_to_stops_[*bus_id], stop_names_, stop_to_buses_, bus_names_);
+
+        return response;
+    }
+
+    AllBusesResponse GetAllBuses() const {
+        AllBusesResponse response;
+        response.buses_to_stops = NameListsView(sorted_buses_, bus_names_, bus_to_stops_, stop_names_);
+        return response;
+    }
+
+    // Маршрут от from до to с наименьшим числом пересадок
+    RouteResponse GetRoute(std::string_view from, std::string_view to) const {
+        RouteResponse response;
+
+        const auto from_id = stop_names_.Find(from);
+        const auto to_id = stop_names_.Find(to);
+        if (!from_id || !to_id || stop_to_buses_[*from_id].empty() || stop_to_buses_[*to_id].empty()) {
+            return response;
+        }
+        response.from = stop_names_.GetName(*from_id);
+        response.to = stop_names_.GetName(*to_id);
+
+        const auto legs = transfer_table_.HasRoute(*from_id, *to_id)
+            ? transfer_table_.FindRoute(*from_id, *to_id)
+            : route_search::FindRoute(bus_to_stops_, stop_to_buses_, *from_id, *to_id);
+        if (!legs) {
+            return response;
+        }
+
+        response.found = true;
+        response.legs.reserve(legs->size());
+        for (const route_search::RouteLeg& leg : *legs) {
+            response.legs.emplace_back(bus_names_.GetName(leg.bus), stop_names_.GetName(leg.stop));
+        }
+
+        return response;
+    }
+
+    // Строит таблицу маршрутов от hub_count узловых остановок, через которые проходит
+    // больше всего автобусов: запросы GetRoute к ним обходятся без поиска.
+    // Таблица сбрасывается при любом изменении маршрутов и не входит в снимок
+    void BuildTransferTable(size_t hub_count) {
+        transfer_table_ = route_search::TransferTable(bus_to_stops_, stop_to_buses_, hub_count);
+    }
+
+    // Записывает данные в двоичном формате снимка, см. bus_snapshot.h
+    void SaveSnapshot(std::ostream& output) const {
+        using namespace bus_snapshot;
+
+        PayloadWriter writer;
+
+        std::uint32_t string_bytes = 0;
+        for (const StringInterner* names : {&stop_names_, &bus_names_}) {
+            for (StringInterner::Id id = 0; id < names->GetSize(); ++id) {
+                writer.PutU32(string_bytes);
+                string_bytes += ToSnapshotSize(names->GetName(id).size());
+            }
+        }
+        writer.PutU32(string_bytes);
+
+        const std::uint32_t route_size = PutLists(writer, bus_to_stops_);
+        const std::uint32_t index_size = PutLists(writer, stop_to_buses_);
+        writer.PutU32Array(sorted_buses_.data(), sorted_buses_.size());
+
+        for (const StringInterner* names : {&stop_names_, &bus_names_}) {
+            for (StringInterner::Id id = 0; id < names->GetSize(); ++id) {
+                writer.PutBytes(names->GetName(id));
+            }
+        }
+        writer.Align();
+
+        Header header;
+        header.stop_count = ToSnapshotSize(stop_names_.GetSize());
+        header.bus_count = ToSnapshotSize(bus_names_.GetSize());
+        header.active_bus_count = ToSnapshotSize(sorted_buses_.size());
+        header.route_size = route_size;
+        header.index_size = index_size;
+        header.string_bytes = string_bytes;
+        header.checksum = Checksum(writer.GetPayload());
+
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(writer.GetPayload().data(), static_cast<std::streamsize>(writer.GetPayload().size()));
+    }
+
+    // Восстанавливает менеджер из снимка, например из отображённого в память файла.
+    // Это десериализация: массивы копируются из снимка, а каждое имя заново добавляется
+    // в индекс имён, поэтому загрузка стоит O(размер снимка) с хэшированием всех имён.
+    // По сравнению с повтором команд NEW_BUS она не разбирает текст и не перестраивает
+    // обратный индекс, но данные после неё не ссылаются на снимок.
+    // Выбрасывает std::runtime_error, если данные повреждены или записаны другой версией
+    static BusManager LoadSnapshot(std::string_view data) {
+        using namespace bus_snapshot;
+
+        Header header;
+        if (data.size() < sizeof(header)) {
+            throw std::runtime_error("snapshot is truncated");
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (header.magic != kMagic) {
+            throw std::runtime_error("not a bus manager snapshot");
+        }
+        if (header.version != kVersion) {
+            throw std::runtime_error("unsupported snapshot version " + std::to_string(header.version));
+        }
+
+        const std::string_view payload = data.substr(sizeof(header));
+        if (Checksum(payload) != header.checksum) {
+            throw std::runtime_error("snapshot checksum mismatch");
+        }
+
+        const size_t stop_count = header.stop_count;
+        const size_t bus_count = header.bus_count;
+
+        PayloadReader reader(payload);
+        const auto name_offsets = reader.GetU32Array(stop_count + bus_count + 1);
+        const auto route_offsets = reader.GetU32Array(bus_count + 1);
+        const auto route_ids = reader.GetU32Array(header.route_size);
+        const auto index_offsets = reader.GetU32Array(stop_count + 1);
+        const auto index_ids = reader.GetU32Array(header.index_size);
+        const auto sorted_buses = reader.GetU32Array(header.active_bus_count);
+        const std::string_view strings = reader.GetBytes(header.string_bytes);
+        if (reader.GetRemaining() != (4 - header.string_bytes % 4) % 4) {
+            throw std::runtime_error("snapshot is corrupted");
+        }
+
+        BusManager manager;
+        ReadNames(manager.stop_names_, strings, name_offsets, 0, stop_count);
+        ReadNames(manager.bus_names_, strings, name_offsets, stop_count, bus_count);
+        manager.bus_to_stops_ = ReadLists(route_offsets, route_ids, stop_count);
+        manager.stop_to_buses_ = ReadLists(index_offsets, index_ids, bus_count);
+
+        // По порядку имён определяется, какие автобусы действуют, поэтому он должен быть строгим
+        for (size_t i = 0; i < sorted_buses.size(); ++i) {
+            if (sorted_buses[i] >= bus_count
+                || (i > 0 && manager.bus_names_.GetName(sorted_buses[i - 1]) >= manager.bus_names_.GetName(sorted_buses[i]))) {
+                throw std::runtime_error("snapshot is corrupted");
+            }
+        }
+        manager.sorted_buses_ = sorted_buses;
+
+        return manager;
+    }
+
+    void SaveSnapshotFile(const std::string& path) const {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        SaveSnapshot(output);
+        if (!output) {
+            throw std::runtime_error("cannot write snapshot to " + path);
+        }
+    }
+
+    static BusManager LoadSnapshotFile(const std::string& path) {
+        const bus_snapshot::MappedFile file(path);
+        return LoadSnapshot(file.GetData());
+    }
+
+private:
+    static std::uint32_t ToSnapshotSize(size_t size) {
+        if (size > UINT32_MAX) {
+            throw std::length_error("bus manager is too large for a snapshot");
+        }
+        return static_cast<std::uint32_t>(size);
+    }
+
+    // Записывает смещения списков и их содержимое подряд, возвращает общую длину списков
+    static std::uint32_t PutLists(bus_snapshot::PayloadWriter& writer, const std::vector<std::vector<StringInterner::Id>>& lists) {
+        std::uint32_t offset = 0;
+        for (const auto& list : lists) {
+            writer.PutU32(offset);
+            offset = ToSnapshotSize(size_t{offset} + list.size());
+        }
+        writer.PutU32(offset);
+
+        for (const auto& list : lists) {
+            writer.PutU32Array(list.data(), list.size());
+        }
+        return offset;
+    }
+
+    // Смещения должны начинаться с нуля, не убывать и заканчиваться на size
+    static void CheckOffsets(const std::vector<std::uint32_t>& offsets, size_t first, size_t count, size_t size) {
+        if ((first == 0 && offsets[0] != 0) || offsets[first + count] > size || (first + count + 1 == offsets.size() && offsets.back() != size)) {
+            throw std::runtime_error("snapshot is corrupted");
+        }
+        for (size_t i = first; i < first + count; ++i) {
+            if (offsets[i] > offsets[i + 1]) {
+                throw std::runtime_error("snapshot is corrupted");
+            }
+        }
+    }
+
+    static void ReadNames(StringInterner& names, std::string_view strings, const std::vector<std::uint32_t>& offsets,
+                          size_t first, size_t count) {
+        CheckOffsets(offsets, first, count, strings.size());
+        names.Reserve(count);
+        for (size_t i = first; i < first + count; ++i) {
+            // Повторяющееся имя получило бы чужой идентификатор
+            if (names.Intern(strings.substr(offsets[i], offsets[i + 1] - offsets[i])) != i - first) {
+                throw std::runtime_error("snapshot is corrupted");
+            }
+        }
+    }
+
+    static std::vector<std::vector<StringInterner::Id>> ReadLists(const std::vector<std::uint32_t>& offsets,
+                                                                  const std::vector<std::uint32_t>& ids, size_t id_count) {
+        CheckOffsets(offsets, 0, offsets.size() - 1, ids.size());
+        for (std::uint32_t id : ids) {
+            if (id >= id_count) {
+                throw std::runtime_error("snapshot is corrupted");
+            }
+        }
+
+        std::vector<std::vector<StringInterner::Id>> lists(offsets.size() - 1);
+        for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+            lists[i].assign(ids.begin() + offsets[i], ids.begin() + offsets[i + 1]);
+        }
+        return lists;
+    }
+
+    std::vector<BusId>::const_iterator FindInSortedBuses(std::string_view name) const {
+        return std::lower_bound(sorted_buses_.begin(), sorted_buses_.end(), name,
+                                [this](BusId id, std::string_view value) {
+                                    return bus_names_.GetName(id) < value;
+                                });
+    }
+
+    void InsertIntoSortedBuses(BusId bus_id) {
+        sorted_buses_.insert(FindInSortedBuses(bus_names_.GetName(bus_id)), bus_id);
+    }
+
+    // Имена интернируются навсегда, поэтому удалённый автобус сохраняет идентификатор;
+    // действующие автобусы - те, что есть в sorted_buses_
+    bool IsActive(BusId bus_id) const {
+        const auto it = FindInSortedBuses(bus_names_.GetName(bus_id));
+        return it != sorted_buses_.end() && *it == bus_id;
+    }
+
+    static std::vector<StopId> GetUniqueStops(std::vector<StopId> stops) {
+        std::sort(stops.begin(), stops.end());
+        stops.erase(std::unique(stops.begin(), stops.end()), stops.end());
+        return stops;
+    }
+
+    void EraseFromIndex(StopId stop_id, BusId bus_id) {
+        std::vector<BusId>& buses = stop_to_buses_[stop_id];
+        buses.erase(std::find(buses.begin(), buses.end(), bus_id));
+    }
+
+    // Ставит автобусу новый маршрут, изменяя обратный индекс только по разнице
+    // множеств остановок старого и нового маршрутов.
+    // Автобус попадает в список остановки один раз, даже если проезжает её несколько раз
+    void SetRoute(BusId bus_id, const std::vector<std::string>& stops) {
+        std::vector<StopId> route;
+        route.reserve(stops.size());
+        for (const std::string& stop : stops) {
+            const StopId stop_id = stop_names_.Intern(stop);
+            if (stop_id == stop_to_buses_.size()) {
+                stop_to_buses_.emplace_back();
+            }
+            route.push_back(stop_id);
+        }
+
+        const std::vector<StopId> old_stops = GetUniqueStops(bus_to_stops_[bus_id]);
+        const std::vector<StopId> new_stops = GetUniqueStops(route);
+
+        std::vector<StopId> removed_stops;
+        std::set_difference(old_stops.begin(), old_stops.end(), new_stops.begin(), new_stops.end(),
+                            std::back_inserter(removed_stops));
+        std::vector<StopId> added_stops;
+        std::set_difference(new_stops.begin(), new_stops.end(), old_stops.begin(), old_stops.end(),
+                            std::back_inserter(added_stops));
+
+        for (StopId stop_id : removed_stops) {
+            EraseFromIndex(stop_id, bus_id);
+        }
+        for (StopId stop_id : added_stops) {
+            stop_to_buses_[stop_id].push_back(bus_id);
+        }
+
+        bus_to_stops_[bus_id] = std::move(route);
+        transfer_table_ = {};
+    }
+
+private:
+    // Имена остановок и автобусов хранятся один раз, маршруты и обратные индексы
+    // хранят только их идентификаторы
+    StringInterner stop_names_;
+    StringInterner bus_names_;
+    std::vector<std::vector<StopId>> bus_to_stops_;
+    std::vector<std::vector<BusId>> stop_to_buses_;
+    // Порядок автобусов по имени нужен только для GetAllBuses
+    std::vector<BusId> sorted_buses_;
+    route_search::TransferTable transfer_table_;
+};
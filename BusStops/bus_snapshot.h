@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Двоичный формат снимка BusManager.
+// Файл - заголовок и полезная нагрузка из массивов uint32 в порядке байтов машины:
+//   смещения имён (остановки, затем автобусы) в блоке строк, stop_count + bus_count + 1
+//   смещения маршрутов, bus_count + 1, и идентификаторы остановок маршрутов
+//   смещения списков автобусов остановок, stop_count + 1, и идентификаторы автобусов
+//   действующие (не удалённые) автобусы в порядке имён, active_bus_count
+//   блок строк, дополненный нулями до кратного 4 размера
+// Массивы выровнены на 4 байта и читаются из отображённого в память файла без
+// разбора текста. Загрузка при этом всё равно копирует данные в структуры BusManager
+// и заново строит индекс имён, см. BusManager::LoadSnapshot
+namespace bus_snapshot {
+
+// "BUSS" при чтении в порядке little-endian; другой порядок байтов даст другое число
+inline constexpr std::uint32_t kMagic = 0x53535542;
+inline constexpr std::uint32_t kVersion = 1;
+
+struct Header {
+    std::uint32_t magic = kMagic;
+    std::uint32_t version = kVersion;
+    std::uint32_t stop_count = 0;
+    std::uint32_t bus_count = 0;
+    std::uint32_t active_bus_count = 0;
+    std::uint32_t route_size = 0;
+    std::uint32_t index_size = 0;
+    std::uint32_t string_bytes = 0;
+    // FNV-1a полезной нагрузки
+    std::uint32_t checksum = 0;
+};
+
+inline std::uint32_t Checksum(std::string_view data) noexcept {
+    std::uint32_t hash = 2166136261u;
+    for (char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Собирает полезную нагрузку снимка
+class PayloadWriter {
+public:
+    void PutU32(std::uint32_t value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        payload_.append(bytes, sizeof(value));
+    }
+
+    void PutU32Array(const std::uint32_t* values, size_t count) {
+        payload_.append(reinterpret_cast<const char*>(values), count * sizeof(std::uint32_t));
+    }
+
+    void PutBytes(std::string_view bytes) {
+        payload_.append(bytes);
+    }
+
+    // Дополняет нагрузку нулями до кратного 4 размера
+    void Align() {
+        payload_.resize((payload_.size() + 3) / 4 * 4, '\0');
+    }
+
+    const std::string& GetPayload() const noexcept {
+        return payload_;
+    }
+
+private:
+    std::string payload_;
+};
+
+// Последовательно читает полезную нагрузку, проверяя её границы
+class PayloadReader {
+public:
+    explicit PayloadReader(std::string_view payload) noexcept
+    : payload_(payload) {
+    }
+
+    std::vector<std::uint32_t> GetU32Array(size_t count) {
+        if (count > payload_.size() / sizeof(std::uint32_t)) {
+            throw std::runtime_error("snapshot is truncated");
+        }
+        std::vector<std::uint32_t> values(count);
+        if (count == 0) {
+            return values;
+        }
+        std::memcpy(values.data(), GetBytes(count * sizeof(std::uint32_t)).data(), count * sizeof(std::uint32_t));
+        return values;
+    }
+
+    std::string_view GetBytes(size_t count) {
+        if (count > payload_.size()) {
+            throw std::runtime_error("snapshot is truncated");
+        }
+        const std::string_view bytes = payload_.substr(0, count);
+        payload_.remove_prefix(count);
+        return bytes;
+    }
+
+    size_t GetRemaining() const noexcept {
+        return payload_.size();
+    }
+
+private:
+    std::string_view payload_;
+};
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            ThrowSystemError("open");
+        }
+
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat");
+        }
+
+        size_ = static_cast<size_t>(file_stat.st_size);
+        if (size_ > 0) {
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "mmap");
+            }
+            data_ = static_cast<const char*>(data);
+        }
+        // Отображение остаётся действительным и после закрытия файла
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    std::string_view GetData() const noexcept {
+        return {data_, size_};
+    }
+
+private:
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace bus_snapshot
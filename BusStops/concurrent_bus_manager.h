@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bus_manager.h"
+
+// BusManager для одновременных чтения и записи.
+// Читатели получают неизменяемую версию через GetSnapshot и выполняют запросы
+// без блокировок. Писатель держит две копии данных: изменение вносится в копию,
+// которую никто не читает, затем она публикуется подменой атомарного указателя,
+// и после ухода последнего читателя старой версии то же изменение повторяется на ней.
+// Поэтому запись стоит O(изменения), а не копирования всех данных.
+// Читатель отмечает читаемую версию в своей ячейке (hazard pointer), писатель
+// перед повторным изменением ждёт, пока ни одна ячейка не указывает на старую версию
+class ConcurrentBusManager {
+    struct Slot;
+
+public:
+    // Больше снимков одновременно держать нельзя, см. GetSnapshot
+    static constexpr size_t kDefaultMaxSnapshots = 256;
+
+    // Версия данных, доступная только для чтения. Пока снимок жив, его версия
+    // не изменяется. Снимок нельзя копировать, только перемещать
+    class Snapshot {
+    public:
+        Snapshot() = default;
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        Snapshot(Snapshot&& other) noexcept
+        : slot_(std::exchange(other.slot_, nullptr))
+        , manager_(std::exchange(other.manager_, nullptr)) {
+        }
+
+        Snapshot& operator=(Snapshot&& other) noexcept {
+            if (this != &other) {
+                Reset();
+                slot_ = std::exchange(other.slot_, nullptr);
+                manager_ = std::exchange(other.manager_, nullptr);
+            }
+            return *this;
+        }
+
+        ~Snapshot() {
+            Reset();
+        }
+
+        // Отпускает версию, после этого писатель может её изменять
+        void Reset() noexcept {
+            if (slot_ != nullptr) {
+                slot_->hazard.store(nullptr, std::memory_order_release);
+                slot_->busy.store(false, std::memory_order_release);
+                slot_ = nullptr;
+                manager_ = nullptr;
+            }
+        }
+
+        explicit operator bool() const noexcept {
+            return manager_ != nullptr;
+        }
+
+        const BusManager& operator*() const noexcept {
+            return *manager_;
+        }
+
+        const BusManager* operator->() const noexcept {
+            return manager_;
+        }
+
+    private:
+        friend class ConcurrentBusManager;
+
+        Snapshot(Slot* slot, const BusManager* manager) noexcept
+        : slot_(slot)
+        , manager_(manager) {
+        }
+
+    private:
+        Slot* slot_ = nullptr;
+        const BusManager* manager_ = nullptr;
+    };
+
+public:
+    // max_snapshots - сколько снимков могут одновременно держать все читатели
+    explicit ConcurrentBusManager(size_t max_snapshots = kDefaultMaxSnapshots)
+    : active_(std::make_unique<BusManager>())
+    , standby_(std::make_unique<BusManager>())
+    , published_(active_.get())
+    , slots_(std::make_unique<Slot[]>(std::max<size_t>(max_snapshots, 1)))
+    , slot_count_(std::max<size_t>(max_snapshots, 1)) {
+    }
+
+    ConcurrentBusManager(const ConcurrentBusManager&) = delete;
+    ConcurrentBusManager& operator=(const ConcurrentBusManager&) = delete;
+
+    // Текущая версия данных. Ответы на запросы к ней действительны, пока snapshot жив.
+    // Не блокируется: занимает свободную ячейку и публикует в ней читаемую версию.
+    // Снимок не следует держать долго: пока его держат, следующая запись ждёт.
+    // Поток, держащий снимок, не может изменять данные, см. Modify.
+    // Выбрасывает std::length_error, если уже взяты все max_snapshots снимков.
+    // Снимки не должны переживать менеджер
+    Snapshot GetSnapshot() const {
+        Slot& slot = ClaimSlot();
+
+        const BusManager* manager = published_.load();
+        while (true) {
+            slot.hazard.store(manager);
+            // Если после отметки версия всё ещё опубликована, писатель увидит отметку
+            // и не тронет версию, пока снимок жив
+            const BusManager* current = published_.load();
+            if (current == manager) {
+                break;
+            }
+            manager = current;
+        }
+
+        return Snapshot(&slot, manager);
+    }
+
+    void AddBus(std::string_view bus, const std::vector<std::string>& stops) {
+        Modify([bus, &stops](BusManager& manager) {
+            manager.AddBus(bus, stops);
+        });
+    }
+
+    bool UpdateBus(std::string_view bus, const std::vector<std::string>& stops) {
+        bool updated = false;
+        Modify([bus, &stops, &updated](BusManager& manager) {
+            updated = manager.UpdateBus(bus, stops);
+        });
+        return updated;
+    }
+
+    bool RemoveBus(std::string_view bus) {
+        bool removed = false;
+        Modify([bus, &removed](BusManager& manager) {
+            removed = manager.RemoveBus(bus);
+        });
+        return removed;
+    }
+
+    void BuildTransferTable(size_t hub_count) {
+        Modify([hub_count](BusManager& manager) {
+            manager.BuildTransferTable(hub_count);
+        });
+    }
+
+    // Применяет change к данным и публикует новую версию. change вызывается дважды,
+    // по разу для каждой копии, и должен изменять их одинаково.
+    // Если change выбрасывает исключение при первом вызове, данные не меняются
+    // и исключение передаётся дальше. Второй вызов изменяет уже опубликованные
+    // данные, поэтому его исключения не выпускаются, см. ReplayOnStandby.
+    // Ждёт, пока читатели отпустят снимки прежней версии. Если снимок держит сам
+    // вызывающий поток, ожидание было бы вечным, поэтому выбрасывается std::logic_error
+    // и данные не меняются
+    template <typename Change>
+    void Modify(Change change) {
+        std::lock_guard guard(writer_mutex_);
+
+        if (HoldsSnapshot()) {
+            throw std::logic_error("cannot modify bus manager while this thread holds its snapshot");
+        }
+
+        ApplyToStandby(change);
+
+        published_.store(standby_.get());
+        std::swap(active_, standby_);
+
+        // После подмены указателя новые читатели не получат бывшую активную копию,
+        // поэтому ожидание конечно
+        WaitForReaders(standby_.get());
+
+        ReplayOnStandby(change);
+    }
+
+private:
+    // Ячейка читателя. Занимает целую строку кэша, чтобы читатели разных
+    // ячеек не мешали друг другу
+    struct alignas(64) Slot {
+        std::atomic<bool> busy = false;
+        // Версия, которую читает владелец ячейки
+        std::atomic<const BusManager*> hazard = nullptr;
+        // Метка потока-владельца, см. GetThreadToken
+        std::atomic<const void*> owner = nullptr;
+    };
+
+    // Адрес, различающий потоки
+    static const void* GetThreadToken() noexcept {
+        static thread_local const char token = 0;
+        return &token;
+    }
+
+    // Поиск свободной ячейки начинается со своей для каждого потока,
+    // так что обычно хватает одной попытки
+    Slot& ClaimSlot() const {
+        static thread_local const size_t home = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+        for (size_t i = 0; i < slot_count_; ++i) {
+            Slot& slot = slots_[(home + i) % slot_count_];
+            bool expected = false;
+            if (!slot.busy.load(std::memory_order_relaxed)
+                && slot.busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                slot.owner.store(GetThreadToken(), std::memory_order_relaxed);
+                return slot;
+            }
+        }
+        throw std::length_error("too many bus manager snapshots are held at once");
+    }
+
+    // Метку владельца в ячейке пишет только её владелец, поэтому свои снимки
+    // поток находит надёжно
+    bool HoldsSnapshot() const noexcept {
+        const void* token = GetThreadToken();
+        for (size_t i = 0; i < slot_count_; ++i) {
+            const Slot& slot = slots_[i];
+            if (slot.busy.load(std::memory_order_relaxed)
+                && slot.owner.load(std::memory_order_relaxed) == token
+                && slot.hazard.load(std::memory_order_relaxed) != nullptr) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WaitForReaders(const BusManager* manager) const noexcept {
+        for (size_t i = 0; i < slot_count_; ++i) {
+            while (slots_[i].hazard.load() == manager) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template <typename Change>
+    void ApplyToStandby(Change& change) {
+        try {
+            change(*standby_);
+        } catch (...) {
+            // Частично изменённую копию восстанавливаем по опубликованной
+            *standby_ = *active_;
+            throw;
+        }
+    }
+
+    // Повторяет опубликованное изменение на второй копии. Если change выбросит
+    // исключение, копия восстанавливается копированием опубликованной. Если не удастся
+    // и это, копии разошлись бы, поэтому программа завершается через std::terminate
+    template <typename Change>
+    void ReplayOnStandby(Change& change) noexcept {
+        try {
+            change(*standby_);
+        } catch (...) {
+            *standby_ = *active_;
+        }
+    }
+
+private:
+    std::mutex writer_mutex_;
+    // Копии данных: active_ опубликована в published_, standby_ доступна только писателю
+    std::unique_ptr<BusManager> active_;
+    std::unique_ptr<BusManager> standby_;
+    std::atomic<const BusManager*> published_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t slot_count_;
+};
@@ -1,212 +1,28 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
 #include <sstream>
+#include <thread>
+
+#include "batch_processor.h"
+#include "bus_manager.h"
+#include "concurrent_bus_manager.h"
+#include "query.h"
+#include "query_reader.h"
+#include "response_writer.h"
+#include "string_interner.h"
 
 
 using namespace std;
 using namespace std::literals;
 
-enum class QueryType {
-    NewBus,
-    BusesForStop,
-    StopsForBus,
-    AllBuses,
-};
-
-struct Query {
-    QueryType type;
-    string bus;
-    string stop;
-    vector<string> stops;
-};
-
-istream& operator>>(istream& is, Query& q) {
-    string operation_code;
-    is >> operation_code;
-
-    if (operation_code == "NEW_BUS"s) {
-        q.type = QueryType::NewBus;
-        
-        is >> q.bus;
-         
-        int stop_count;
-        
-        is >> stop_count;
-
-        q.stops.resize(stop_count);
-        
-        for (string& stop : q.stops) {
-            is >> stop;
-        }
-        
-    } else if (operation_code == "BUSES_FOR_STOP"s) {
-        q.type = QueryType::BusesForStop;
-        
-        is >> q.stop;
-        
-    } else if (operation_code == "STOPS_FOR_BUS"s) {
-        q.type = QueryType::StopsForBus;
-        
-        is >> q.bus;
-        
-    } else if (operation_code == "ALL_BUSES"s) {
-        q.type = QueryType::AllBuses;
-    }
-    
-    return is;
-}
-
-struct BusesForStopResponse {
-    vector<string> buses;
-};
-
-ostream& operator<<(ostream& os, const BusesForStopResponse& r) {
-    if (r.buses.empty()) {
-        os << "No stop"s;
-    } else {
-        bool isFirst = true;
-        for (const string& bus : r.buses) {
-            // avoid extra space at the end of the output
-            if(isFirst) {
-                os << bus;
-                isFirst = false;
-                continue;
-            }
-            os << " "s << bus;
-        }
-    }
-    return os;
-}
-
-struct StopsForBusResponse {
-    string bus;
-    vector<pair<string, vector<string>>> stops_to_buses;
-};
-
-ostream& operator<<(ostream& os, const StopsForBusResponse& r) {
-    if (r.stops_to_buses.empty()) {
-        os << "No bus"s;
-    } else {
-        bool isFirstLine = true;
-        
-        for (const auto& [stop, buses] : r.stops_to_buses) {
-            if (isFirstLine) {
-                isFirstLine = false;
-            } else {
-                os << endl;
-            }
-            
-            os << "Stop "s << stop << ": "s;
-            if (buses.size() == 1) {
-                os << "no interchange"s;
-            } else {
-                bool isFirstBus = true;
-                for (const string& other_bus : buses) {
-                    if (r.bus != other_bus) {
-                        if(isFirstBus) {
-                            os << other_bus;
-                            isFirstBus = false;
-                            continue;
-                        }
-                        os << " "s << other_bus;
-                    }
-                }
-            }
-        }
-    }
-    
-    return os;
-}
-
-struct AllBusesResponse {
-    map<string, vector<string>> buses_to_stops;
-};
-
-ostream& operator<<(ostream& os, const AllBusesResponse& r) {
-    if (r.buses_to_stops.empty()) {
-        os << "No buses"s;
-    } else {
-        bool isFirstLine = true;
-        for (const auto& bus_item : r.buses_to_stops) {
-            if (isFirstLine) {
-                isFirstLine = false;
-            } else {
-                os << endl;
-            }
-            
-            os << "Bus "s << bus_item.first << ": "s;
-            bool isFirstStop = true;
-            for (const string& stop : bus_item.second) {
-                if(isFirstStop) {
-                    os << stop;
-                    isFirstStop = false;
-                    continue;
-                }
-                os << " "s << stop ;
-            }
-        }
-    }
-    return os;
-}
-
-class BusManager {
-public:
-    void AddBus(const string& bus, const vector<string>& stops) {
-        buses_to_stops_[bus] = stops;
-        for (const string& stop : stops) {
-            stops_to_buses_[stop].push_back(bus);
-        }
-    }
-
-    BusesForStopResponse GetBusesForStop(const string& stop) const {
-        BusesForStopResponse response;
-        
-        if (stops_to_buses_.count(stop) == 0) {
-            return response;
-        }
-        
-        response.buses = stops_to_buses_.at(stop);
-        
-        return response;
-    }
-
-    StopsForBusResponse GetStopsForBus(const string& bus) const {
-        StopsForBusResponse response;
-        
-        if (buses_to_stops_.count(bus) == 0) {
-            return response;
-        }
-        
-        response.bus = bus;
-        
-        for (const string& stop : buses_to_stops_.at(bus)) {
-            response.stops_to_buses.push_back({stop, stops_to_buses_.at(stop)});
-        }
-        
-        return response;
-    }
-
-    AllBusesResponse GetAllBuses() const {
-        AllBusesResponse response;
-        
-        if (buses_to_stops_.empty()) {
-            return response;
-        }
-        
-        for (const auto& [bus, stops] : buses_to_stops_) {
-            response.buses_to_stops[bus] = stops;
-        }
-            
-        return response;
-    }
-
-private:
-    map<string, vector<string>> buses_to_stops_, stops_to_buses_;
-};
-
 void TestQueryInputAllBuses() {
     istringstream input;
     
@@ -271,6 +87,123 @@ void TestQueryInputBusesForStop() {
     assert(query_buses_for_stop.stops.empty() == true);
 }
 
+void TestQueryInputRoute() {
+    istringstream input;
+    
+    input.str("ROUTE Tolstopaltsevo Kokoshkino"s);
+    
+    Query query_route;
+    
+    input >> query_route;
+    
+    assert(query_route.type == QueryType::Route);
+    assert(query_route.stop == "Tolstopaltsevo"s);
+    assert(query_route.destination == "Kokoshkino"s);
+    assert(query_route.bus == ""s);
+    
+    istringstream reader_input("ROUTE Vnukovo\nMarushkino ROUTE Vnukovo"s);
+    QueryReader reader(reader_input, 4);
+    assert(reader.Read(query_route));
+    assert(query_route.type == QueryType::Route);
+    assert(query_route.stop == "Vnukovo"s);
+    assert(query_route.destination == "Marushkino"s);
+    try {
+        reader.Read(query_route);
+        assert(false);
+    } catch (const invalid_argument&) {
+    }
+}
+
+vector<string> ToStrings(const NameSpan& names) {
+    return vector<string>(names.begin(), names.end());
+}
+
+vector<pair<string, vector<string>>> ToStrings(const NameListsView& name_lists) {
+    vector<pair<string, vector<string>>> result;
+    for (const auto& [name, names] : name_lists) {
+        result.emplace_back(name, ToStrings(names));
+    }
+    return result;
+}
+
+void TestQueryReader() {
+    // маленький буфер, чтобы токены попадали на границу блоков
+    istringstream input("3\nNEW_BUS 32 3 Tolstopaltsevo Marushkino Vnukovo\n"s
+                        "BUSES_FOR_STOP   Vnukovo\r\nNEW_BUS 950 2 Kokoshkino Marushkino\nALL_BUSES\n"s);
+    QueryReader reader(input, 4);
+    
+    assert(reader.ReadNumber<int>() == 3);
+    
+    Query query;
+    assert(reader.Read(query));
+    assert(query.type == QueryType::NewBus);
+    assert(query.bus == "32"s);
+    assert((query.stops == vector<string>{"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s}));
+    
+    assert(reader.Read(query));
+    assert(query.type == QueryType::BusesForStop);
+    assert(query.stop == "Vnukovo"s);
+    
+    // строки остановок переиспользуются следующим запросом
+    const char* first_stop = query.stops[0].data();
+    assert(reader.Read(query));
+    assert(query.type == QueryType::NewBus);
+    assert(query.bus == "950"s);
+    assert((query.stops == vector<string>{"Kokoshkino"s, "Marushkino"s}));
+    assert(query.stops[0].data() == first_stop);
+    
+    assert(reader.Read(query));
+    assert(query.type == QueryType::AllBuses);
+    
+    assert(!reader.Read(query));
+}
+
+void TestQueryReaderErrors() {
+    {
+        istringstream input("NEW_BUS 32 x Vnukovo"s);
+        QueryReader reader(input);
+        Query query;
+        try {
+            reader.Read(query);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+    }
+    {
+        istringstream input("REMOVE_STOP Vnukovo"s);
+        QueryReader reader(input);
+        Query query;
+        try {
+            reader.Read(query);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+    }
+    {
+        istringstream input("STOPS_FOR_BUS"s);
+        QueryReader reader(input);
+        Query query;
+        try {
+            reader.Read(query);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+    }
+    {
+        // Огромное количество остановок не выделяет память заранее,
+        // ошибка обнаруживается, когда остановки во вводе заканчиваются
+        istringstream input("NEW_BUS 32 18446744073709551615 Vnukovo"s);
+        QueryReader reader(input);
+        Query query;
+        try {
+            reader.Read(query);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+        assert(query.stops.size() <= 2);
+    }
+}
+
 void TestOutputBusesForStopNoStop() {
     BusesForStopResponse response;
     
@@ -282,9 +215,11 @@ void TestOutputBusesForStopNoStop() {
 }
 
 void TestOutputBusesForStop() {
-    BusesForStopResponse response;
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("32K"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Skolkovo"s});
     
-    response.buses = {"32"s, "32K"s};
+    BusesForStopResponse response = bus_manager.GetBusesForStop("Vnukovo"s);
     
     ostringstream output;
     
@@ -304,14 +239,13 @@ void TestOutputStopsForBusNoBus() {
 }
 
 void TestOutputStopsForBus() {
-    StopsForBusResponse response;
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("32K"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Skolkovo"s});
+    bus_manager.AddBus("950"s, {"Kokoshkino"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Troparyovo"s});
+    bus_manager.AddBus("272"s, {"Vnukovo"s, "Moskovsky"s, "Rumyantsevo"s, "Troparyovo"s});
     
-    response.bus = "272"s;
-    response.stops_to_buses = {{"Vnukovo", {"32"s, "32K"s, "950"s, "272"s}},
-                               {"Moskovsky"s,{"272"s}},
-                               {"Rumyantsevo"s,{"272"s}},
-                               {"Troparyovo"s,{"950"s, "272"s}}
-                              };
+    StopsForBusResponse response = bus_manager.GetStopsForBus("272"s);
     
     ostringstream output;
     
@@ -331,11 +265,11 @@ void TestOutputAllBusesEmpty() {
 }
 
 void TestOutputAllBuses() {
-    AllBusesResponse response;
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("272"s, {"Vnukovo"s, "Moskovsky"s, "Rumyantsevo"s, "Troparyovo"s});
     
-    response.buses_to_stops = {{"272"s, {"Vnukovo"s, "Moskovsky"s, "Rumyantsevo"s, "Troparyovo"s}},
-                               {"32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s}},
-                              };
+    AllBusesResponse response = bus_manager.GetAllBuses();
     
     ostringstream output;
     output << response;
@@ -343,6 +277,30 @@ void TestOutputAllBuses() {
     assert(output.str() == "Bus 272: Vnukovo Moskovsky Rumyantsevo Troparyovo\nBus 32: Tolstopaltsevo Marushkino Vnukovo"s);
 }
 
+void TestResponseWriter() {
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("272"s, {"Vnukovo"s, "Moskovsky"s});
+    
+    ostringstream expected;
+    expected << bus_manager.GetBusesForStop("Vnukovo"s) << endl
+             << bus_manager.GetStopsForBus("272"s) << endl
+             << bus_manager.GetStopsForBus("777"s) << endl
+             << bus_manager.GetAllBuses() << endl;
+    
+    // буфер меньше одного ответа, чтобы запись шла несколькими блоками
+    ostringstream output;
+    {
+        ResponseWriter writer(output, 8);
+        writer.Write(bus_manager.GetBusesForStop("Vnukovo"s));
+        writer.Write(bus_manager.GetStopsForBus("272"s));
+        writer.Write(bus_manager.GetStopsForBus("777"s));
+        writer.Write(bus_manager.GetAllBuses());
+    }
+    
+    assert(output.str() == expected.str());
+}
+
 void TestGetBusesForStop() {
     BusManager bus_manager;
     /*
@@ -355,7 +313,11 @@ void TestGetBusesForStop() {
     BusesForStopResponse response = bus_manager.GetBusesForStop("Vnukovo"s);
     
     vector<string> desired_data {"32"s, "32K"s};
-    assert(response.buses == desired_data);
+    assert(ToStrings(response.buses) == desired_data);
+    
+    // ответ ссылается на имена, хранящиеся в менеджере, а не на их копии
+    BusesForStopResponse other_response = bus_manager.GetBusesForStop("Marushkino"s);
+    assert((*response.buses.begin()).data() == (*other_response.buses.begin()).data());
 }
 
 void TestGetBusesForStopNonExistentStop() {
@@ -363,8 +325,7 @@ void TestGetBusesForStopNonExistentStop() {
     
     BusesForStopResponse response = bus_manager.GetBusesForStop("Zuevo"s);
     
-    vector<string> desired_data;
-    assert(response.buses == desired_data);
+    assert(response.buses.empty());
 }
 
 void TestGetStopsForBus() {
@@ -391,16 +352,14 @@ void TestGetStopsForBus() {
     
     StopsForBusResponse response = bus_manager.GetStopsForBus("272"s);
     
-    StopsForBusResponse desired_response;
-    desired_response.bus = "272"s;
-    desired_response.stops_to_buses = {{"Vnukovo"s, {"32"s, "32K"s, "950"s, "272"s}},
+    vector<pair<string, vector<string>>> desired_stops_to_buses = {{"Vnukovo"s, {"32"s, "32K"s, "950"s, "272"s}},
                                        {"Moskovsky"s, {"272"s}},
                                        {"Rumyantsevo"s, {"272"s}},
                                        {"Troparyovo"s, {"950"s, "272"s}}
                                       };
     
-    assert(response.bus == desired_response.bus);
-    assert(response.stops_to_buses == desired_response.stops_to_buses);
+    assert(response.bus == "272"s);
+    assert(ToStrings(response.stops_to_buses) == desired_stops_to_buses);
 }
 
 void TestGetStopsForBusNoBus() {
@@ -408,9 +367,7 @@ void TestGetStopsForBusNoBus() {
     
     StopsForBusResponse response = bus_manager.GetStopsForBus("777"s);
     
-    StopsForBusResponse desired_response;
-
-    assert(response.stops_to_buses == desired_response.stops_to_buses);
+    assert(response.stops_to_buses.empty());
 }
 
 void TestGetAllBuses() {
@@ -428,13 +385,13 @@ void TestGetAllBuses() {
     
     AllBusesResponse response = bus_manager.GetAllBuses();
     
-    AllBusesResponse desired_response;
-    desired_response.buses_to_stops = {{"32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s}},
+    map<string, vector<string>> desired_buses_to_stops = {{"32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s}},
                                        {"32K"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Skolkovo"s}},
                                        {"950"s, {"Kokoshkino"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Troparyovo"s}},
                                        {"272"s, {"Vnukovo"s, "Moskovsky"s, "Rumyantsevo"s, "Troparyovo"s}},
                                       };
-    assert(response.buses_to_stops == desired_response.buses_to_stops);
+    vector<pair<string, vector<string>>> buses_to_stops = ToStrings(response.buses_to_stops);
+    assert((buses_to_stops == vector<pair<string, vector<string>>>(desired_buses_to_stops.begin(), desired_buses_to_stops.end())));
 }
 
 void TestGetAllBusesNoBuses() {
@@ -442,16 +399,535 @@ void TestGetAllBusesNoBuses() {
     
     AllBusesResponse response = bus_manager.GetAllBuses();
     
-    AllBusesResponse desired_response;
+    assert(response.buses_to_stops.empty());
+}
+
+void TestStringInterner() {
+    StringInterner interner;
+    
+    const auto vnukovo = interner.Intern("Vnukovo"s);
+    const auto marushkino = interner.Intern("Marushkino"s);
+    
+    assert(vnukovo == 0);
+    assert(marushkino == 1);
+    assert(interner.Intern("Vnukovo"s) == vnukovo);
+    assert(interner.GetSize() == 2);
     
-    assert(response.buses_to_stops == desired_response.buses_to_stops);
+    assert(interner.Find("Marushkino"s) == marushkino);
+    assert(!interner.Find("Zuevo"s));
+    assert(interner.GetName(vnukovo) == "Vnukovo"s);
+    
+    // имена не должны перемещаться при добавлении новых строк
+    const string_view name = interner.GetName(vnukovo);
+    for (int i = 0; i < 1000; ++i) {
+        interner.Intern("Stop"s + to_string(i));
+    }
+    assert(name.data() == interner.GetName(vnukovo).data());
+}
+
+void TestConcurrentBusManager() {
+    ConcurrentBusManager bus_manager;
+    
+    auto empty_snapshot = bus_manager.GetSnapshot();
+    assert(empty_snapshot->GetAllBuses().buses_to_stops.empty());
+    // пока старый снимок жив, запись ждёт; отпускаем его
+    empty_snapshot.Reset();
+    assert(!empty_snapshot);
+    
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("32K"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Skolkovo"s});
+    
+    {
+        const auto snapshot = bus_manager.GetSnapshot();
+        vector<string> desired_data {"32"s, "32K"s};
+        assert(ToStrings(snapshot->GetBusesForStop("Vnukovo"s).buses) == desired_data);
+    }
+    
+    // читатели видят согласованные версии, пока писатель добавляет автобусы
+    const int bus_count = 200;
+    ConcurrentBusManager concurrent_manager;
+    vector<thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&concurrent_manager, bus_count] {
+            size_t last_size = 0;
+            while (last_size < static_cast<size_t>(bus_count)) {
+                const auto snapshot = concurrent_manager.GetSnapshot();
+                const size_t size = snapshot->GetAllBuses().buses_to_stops.size();
+                assert(size >= last_size);
+                assert(snapshot->GetBusesForStop("Center"s).buses.size() == size);
+                last_size = size;
+            }
+        });
+    }
+    for (int i = 0; i < bus_count; ++i) {
+        concurrent_manager.AddBus("Bus"s + to_string(i), {"Center"s, "Stop"s + to_string(i)});
+    }
+    for (thread& reader : readers) {
+        reader.join();
+    }
+    
+    assert(concurrent_manager.RemoveBus("Bus7"s));
+    assert(concurrent_manager.UpdateBus("Bus8"s, {"Center"s}));
+    
+    const auto snapshot = concurrent_manager.GetSnapshot();
+    assert(snapshot->GetStopsForBus("Bus7"s).stops_to_buses.empty());
+    assert(snapshot->GetStopsForBus("Bus8"s).stops_to_buses.size() == 1);
+    assert(snapshot->GetBusesForStop("Center"s).buses.size() == bus_count - 1);
+}
+
+void TestConcurrentBusManagerSnapshotLimits() {
+    ConcurrentBusManager bus_manager(2);
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Vnukovo"s});
+    
+    {
+        auto snapshot = bus_manager.GetSnapshot();
+        // запись из потока, держащего снимок, ждала бы вечно и поэтому отклоняется
+        try {
+            bus_manager.AddBus("950"s, {"Vnukovo"s});
+            assert(false);
+        } catch (const logic_error&) {
+        }
+        assert(snapshot->GetStopsForBus("950"s).stops_to_buses.empty());
+        
+        // перемещённый снимок продолжает удерживать версию
+        ConcurrentBusManager::Snapshot moved = std::move(snapshot);
+        assert(!snapshot && moved);
+        try {
+            bus_manager.RemoveBus("32"s);
+            assert(false);
+        } catch (const logic_error&) {
+        }
+        
+        // ячеек для снимков всего две
+        auto second = bus_manager.GetSnapshot();
+        try {
+            bus_manager.GetSnapshot();
+            assert(false);
+        } catch (const length_error&) {
+        }
+    }
+    
+    // после освобождения снимков запись проходит, данные не пострадали
+    bus_manager.AddBus("950"s, {"Vnukovo"s});
+    const auto snapshot = bus_manager.GetSnapshot();
+    assert((ToStrings(snapshot->GetBusesForStop("Vnukovo"s).buses) == vector<string>{"32"s, "950"s}));
+    
+    // другой поток со своим снимком не мешает записи, когда его отпустит
+    ConcurrentBusManager other_manager;
+    atomic<bool> snapshot_taken = false;
+    thread reader([&other_manager, &snapshot_taken] {
+        auto reader_snapshot = other_manager.GetSnapshot();
+        snapshot_taken = true;
+        this_thread::sleep_for(10ms);
+        assert(reader_snapshot->GetAllBuses().buses_to_stops.empty());
+    });
+    while (!snapshot_taken) {
+        this_thread::yield();
+    }
+    other_manager.AddBus("32"s, {"Vnukovo"s});
+    reader.join();
+    assert(other_manager.GetSnapshot()->GetAllBuses().buses_to_stops.size() == 1);
+}
+
+void TestConcurrentBusManagerFailedChange() {
+    ConcurrentBusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Vnukovo"s});
+    
+    // исключение при первом применении изменения отменяет его
+    try {
+        bus_manager.Modify([](BusManager& manager) {
+            manager.AddBus("broken"s, {"Vnukovo"s});
+            throw runtime_error("change failed"s);
+        });
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    assert(bus_manager.GetSnapshot()->GetStopsForBus("broken"s).stops_to_buses.empty());
+    
+    // изменение уже опубликовано, поэтому исключение при повторе на второй копии
+    // не выпускается, а копия восстанавливается по опубликованной
+    int calls = 0;
+    bus_manager.Modify([&calls](BusManager& manager) {
+        if (calls++ == 1) {
+            manager.AddBus("broken"s, {"Vnukovo"s});
+            throw runtime_error("replay failed"s);
+        }
+        manager.AddBus("950"s, {"Vnukovo"s});
+    });
+    assert(calls == 2);
+    
+    // следующая запись публикует вторую копию, она совпадает с первой
+    for (int i = 0; i < 2; ++i) {
+        bus_manager.AddBus("K"s + to_string(i), {"Solntsevo"s});
+        const auto snapshot = bus_manager.GetSnapshot();
+        assert((ToStrings(snapshot->GetBusesForStop("Vnukovo"s).buses) == vector<string>{"32"s, "950"s}));
+        assert(snapshot->GetStopsForBus("broken"s).stops_to_buses.empty());
+    }
+}
+
+void TestReAddBusReplacesRoute() {
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("950"s, {"Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Vnukovo"s, "Peredelkino"s});
+    
+    // повторное добавление не дублирует автобус в списках остановок
+    assert((ToStrings(bus_manager.GetBusesForStop("Vnukovo"s).buses) == vector<string>{"32"s, "950"s}));
+    assert((ToStrings(bus_manager.GetBusesForStop("Marushkino"s).buses) == vector<string>{"950"s}));
+    assert((ToStrings(bus_manager.GetBusesForStop("Peredelkino"s).buses) == vector<string>{"32"s}));
+    
+    // кольцевой маршрут проходит остановку дважды, но в её списке автобус один раз
+    bus_manager.AddBus("K"s, {"Vnukovo"s, "Solntsevo"s, "Vnukovo"s});
+    assert((ToStrings(bus_manager.GetBusesForStop("Vnukovo"s).buses) == vector<string>{"32"s, "950"s, "K"s}));
+    assert(bus_manager.GetStopsForBus("K"s).stops_to_buses.size() == 3);
+}
+
+void TestUpdateBus() {
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("950"s, {"Kokoshkino"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("272"s, {"Vnukovo"s, "Moskovsky"s});
+    
+    assert(bus_manager.UpdateBus("950"s, {"Kokoshkino"s, "Vnukovo"s, "Troparyovo"s}));
+    assert(!bus_manager.UpdateBus("777"s, {"Vnukovo"s}));
+    
+    // у остановки, оставшейся в маршруте, автобус сохраняет своё место
+    assert((ToStrings(bus_manager.GetBusesForStop("Vnukovo"s).buses) == vector<string>{"32"s, "950"s, "272"s}));
+    assert((ToStrings(bus_manager.GetBusesForStop("Marushkino"s).buses) == vector<string>{"32"s}));
+    assert((ToStrings(bus_manager.GetBusesForStop("Troparyovo"s).buses) == vector<string>{"950"s}));
+    assert(bus_manager.GetStopsForBus("777"s).stops_to_buses.empty());
+    
+    ostringstream output;
+    output << bus_manager.GetStopsForBus("950"s);
+    assert(output.str() == "Stop Kokoshkino: no interchange\nStop Vnukovo: 32 272\nStop Troparyovo: no interchange"s);
+}
+
+void TestRemoveBus() {
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("272"s, {"Vnukovo"s, "Moskovsky"s});
+    
+    assert(bus_manager.RemoveBus("32"s));
+    assert(!bus_manager.RemoveBus("32"s));
+    assert(!bus_manager.RemoveBus("777"s));
+    
+    ostringstream output;
+    output << bus_manager.GetBusesForStop("Marushkino"s) << endl
+           << bus_manager.GetBusesForStop("Vnukovo"s) << endl
+           << bus_manager.GetStopsForBus("32"s) << endl
+           << bus_manager.GetAllBuses();
+    assert(output.str() == "No stop\n272\nNo bus\nBus 272: Vnukovo Moskovsky"s);
+    
+    // удалённый автобус можно добавить снова
+    assert(!bus_manager.UpdateBus("32"s, {"Vnukovo"s}));
+    bus_manager.AddBus("32"s, {"Vnukovo"s});
+    assert((ToStrings(bus_manager.GetBusesForStop("Vnukovo"s).buses) == vector<string>{"272"s, "32"s}));
+    
+    assert(bus_manager.RemoveBus("272"s));
+    ostringstream snapshot;
+    bus_manager.SaveSnapshot(snapshot);
+    const BusManager loaded = BusManager::LoadSnapshot(snapshot.str());
+    ostringstream loaded_output;
+    loaded_output << loaded.GetAllBuses() << endl << loaded.GetStopsForBus("272"s);
+    assert(loaded_output.str() == "Bus 32: Vnukovo\nNo bus"s);
+}
+
+void TestGetRoute() {
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("950"s, {"Kokoshkino"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("272"s, {"Vnukovo"s, "Moskovsky"s, "Rumyantsevo"s});
+    bus_manager.AddBus("K"s, {"Rumyantsevo"s, "Troparyovo"s});
+    bus_manager.AddBus("Z"s, {"Lyubertsy"s, "Zhulebino"s});
+    
+    ostringstream output;
+    output << bus_manager.GetRoute("Tolstopaltsevo"s, "Marushkino"s) << endl
+           << bus_manager.GetRoute("Tolstopaltsevo"s, "Troparyovo"s) << endl
+           << bus_manager.GetRoute("Troparyovo"s, "Tolstopaltsevo"s) << endl
+           << bus_manager.GetRoute("Vnukovo"s, "Vnukovo"s) << endl
+           << bus_manager.GetRoute("Vnukovo"s, "Zhulebino"s) << endl
+           << bus_manager.GetRoute("Vnukovo"s, "Khimki"s) << endl;
+    assert(output.str() == "Transfers 0: 32 to Marushkino\n"s
+                           "Transfers 2: 32 to Vnukovo, 272 to Rumyantsevo, K to Troparyovo\n"s
+                           "Transfers 2: K to Rumyantsevo, 272 to Vnukovo, 32 to Tolstopaltsevo\n"s
+                           "No bus needed\n"s
+                           "No route\n"s
+                           "No stop\n"s);
+    
+    // после удаления автобуса маршрут ищется заново
+    bus_manager.BuildTransferTable(2);
+    assert(bus_manager.GetRoute("Rumyantsevo"s, "Kokoshkino"s).legs.size() == 2);
+    assert(bus_manager.RemoveBus("272"s));
+    assert(!bus_manager.GetRoute("Rumyantsevo"s, "Kokoshkino"s).found);
+    assert(bus_manager.GetRoute("Moskovsky"s, "Kokoshkino"s).from.empty());
+}
+
+// Число автобусов в кратчайшем маршруте обычным поиском в ширину, -1 - если маршрута нет
+int CountRouteBuses(const map<string, vector<string>>& routes, const string& from, const string& to) {
+    map<string, int> stop_buses{{from, 0}};
+    vector<string> queue{from};
+    for (size_t i = 0; i < queue.size(); ++i) {
+        const string stop = queue[i];
+        for (const auto& [bus, bus_stops] : routes) {
+            if (find(bus_stops.begin(), bus_stops.end(), stop) == bus_stops.end()) {
+                continue;
+            }
+            for (const string& next_stop : bus_stops) {
+                if (stop_buses.emplace(next_stop, stop_buses[stop] + 1).second) {
+                    queue.push_back(next_stop);
+                }
+            }
+        }
+    }
+    return stop_buses.count(to) ? stop_buses[to] : -1;
+}
+
+// Маршрут должен вести от from до to по существующим автобусам с наименьшим числом пересадок
+void AssertShortestRoute(const BusManager& bus_manager, const map<string, vector<string>>& routes,
+                         const string& from, const string& to) {
+    const RouteResponse response = bus_manager.GetRoute(from, to);
+    const int bus_count = CountRouteBuses(routes, from, to);
+    assert(response.found == (bus_count >= 0));
+    if (!response.found) {
+        return;
+    }
+    assert(response.legs.size() == static_cast<size_t>(bus_count));
+    
+    string stop = from;
+    for (const auto& [bus, next_stop] : response.legs) {
+        const vector<string>& bus_stops = routes.at(string(bus));
+        assert(find(bus_stops.begin(), bus_stops.end(), stop) != bus_stops.end());
+        assert(find(bus_stops.begin(), bus_stops.end(), next_stop) != bus_stops.end());
+        stop = next_stop;
+    }
+    assert(stop == to);
+}
+
+void TestRouteIsShortest() {
+    // случайные редкие сети, чтобы встречались и длинные маршруты, и недостижимые остановки
+    for (int seed = 0; seed < 20; ++seed) {
+        BusManager bus_manager;
+        map<string, vector<string>> routes;
+        unsigned state = seed + 1;
+        const auto next_random = [&state](unsigned bound) {
+            state = state * 1103515245u + 12345u;
+            return (state >> 16) % bound;
+        };
+        
+        for (int bus = 0; bus < 30; ++bus) {
+            vector<string>& stops = routes["B"s + to_string(bus)];
+            const unsigned stop_count = 2 + next_random(3);
+            for (unsigned i = 0; i < stop_count; ++i) {
+                stops.push_back("S"s + to_string(next_random(60)));
+            }
+            bus_manager.AddBus("B"s + to_string(bus), stops);
+        }
+        
+        vector<string> stops;
+        for (const auto& [bus, bus_stops] : routes) {
+            stops.insert(stops.end(), bus_stops.begin(), bus_stops.end());
+        }
+        sort(stops.begin(), stops.end());
+        stops.erase(unique(stops.begin(), stops.end()), stops.end());
+        
+        for (size_t hub_count : {0, 5}) {
+            bus_manager.BuildTransferTable(hub_count);
+            for (const string& from : stops) {
+                for (const string& to : stops) {
+                    AssertShortestRoute(bus_manager, routes, from, to);
+                }
+            }
+        }
+    }
+}
+
+string RenderAllQueries(const BusManager& bus_manager, const vector<string>& stops, const vector<string>& buses) {
+    ostringstream output;
+    for (const string& stop : stops) {
+        output << bus_manager.GetBusesForStop(stop) << endl;
+    }
+    for (const string& bus : buses) {
+        output << bus_manager.GetStopsForBus(bus) << endl;
+    }
+    output << bus_manager.GetAllBuses() << endl;
+    return output.str();
+}
+
+template <typename Function>
+void AssertSnapshotRejected(Function load) {
+    try {
+        load();
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+}
+
+void TestSnapshot() {
+    BusManager bus_manager;
+    bus_manager.AddBus("32"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s});
+    bus_manager.AddBus("32K"s, {"Tolstopaltsevo"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Skolkovo"s});
+    bus_manager.AddBus("950"s, {"Kokoshkino"s, "Marushkino"s, "Vnukovo"s, "Peredelkino"s, "Solntsevo"s, "Troparyovo"s});
+    bus_manager.AddBus("272"s, {"Vnukovo"s, "Moskovsky"s, "Rumyantsevo"s, "Troparyovo"s});
+    
+    const vector<string> stops{"Vnukovo"s, "Marushkino"s, "Troparyovo"s, "Zuevo"s};
+    const vector<string> buses{"32"s, "32K"s, "950"s, "272"s, "777"s};
+    const string expected = RenderAllQueries(bus_manager, stops, buses);
+    
+    ostringstream output;
+    bus_manager.SaveSnapshot(output);
+    const string snapshot = output.str();
+    
+    BusManager loaded = BusManager::LoadSnapshot(snapshot);
+    assert(RenderAllQueries(loaded, stops, buses) == expected);
+    
+    // загруженный менеджер продолжает принимать автобусы
+    loaded.AddBus("1"s, {"Vnukovo"s, "Zuevo"s});
+    assert(ToStrings(loaded.GetBusesForStop("Zuevo"s).buses) == vector<string>{"1"s});
+    
+    ostringstream empty_output;
+    BusManager().SaveSnapshot(empty_output);
+    assert(BusManager::LoadSnapshot(empty_output.str()).GetAllBuses().buses_to_stops.empty());
+    
+    const string path = (filesystem::temp_directory_path() / "bus_manager_snapshot_test.bin"s).string();
+    bus_manager.SaveSnapshotFile(path);
+    assert(RenderAllQueries(BusManager::LoadSnapshotFile(path), stops, buses) == expected);
+    remove(path.c_str());
+    
+    string corrupted = snapshot;
+    corrupted[corrupted.size() - 5] ^= 1;
+    AssertSnapshotRejected([&corrupted] { BusManager::LoadSnapshot(corrupted); });
+    
+    string other_version = snapshot;
+    ++other_version[sizeof(uint32_t)];
+    AssertSnapshotRejected([&other_version] { BusManager::LoadSnapshot(other_version); });
+    
+    AssertSnapshotRejected([&snapshot] { BusManager::LoadSnapshot(string_view(snapshot).substr(0, snapshot.size() - 4)); });
+    AssertSnapshotRejected([] { BusManager::LoadSnapshot("NEW_BUS 32 1 Vnukovo"sv); });
+}
+
+void TestThreadPool() {
+    ThreadPool pool(4);
+    assert(pool.GetThreadCount() == 4);
+    
+    vector<atomic<int>> counters(1000);
+    for (int repeat = 0; repeat < 10; ++repeat) {
+        pool.Run(counters.size(), [&counters](size_t index) {
+            ++counters[index];
+        });
+    }
+    for (const atomic<int>& counter : counters) {
+        assert(counter == 10);
+    }
+    
+    try {
+        pool.Run(100, [](size_t index) {
+            if (index == 42) {
+                throw runtime_error("task failed"s);
+            }
+        });
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+}
+
+void TestBatchProcessing() {
+    // запросы чтения чередуются с NEW_BUS, часть групп длиннее одной порции
+    ostringstream input;
+    int query_count = 0;
+    for (int bus = 0; bus < 20; ++bus) {
+        input << "NEW_BUS "s << bus << " 3 Center Stop"s << bus << " Stop"s << bus + 1 << '\n';
+        const int read_count = bus % 3 == 0 ? 50 : 2;
+        for (int i = 0; i < read_count; ++i) {
+            switch (i % 4) {
+                case 0:
+                    input << "BUSES_FOR_STOP Stop"s << i % 25 << '\n';
+                    break;
+                case 1:
+                    input << "STOPS_FOR_BUS "s << i % 25 << '\n';
+                    break;
+                case 2:
+                    input << "ROUTE Stop"s << i % 25 << " Stop"s << i % 7 << '\n';
+                    break;
+                default:
+                    input << "ALL_BUSES\n"s;
+            }
+        }
+        query_count += 1 + read_count;
+    }
+    
+    // последовательная обработка как эталон
+    ostringstream expected;
+    {
+        istringstream queries(input.str());
+        QueryReader reader(queries);
+        ResponseWriter writer(expected);
+        BusManager manager;
+        Query query;
+        while (reader.Read(query)) {
+            if (query.type == QueryType::NewBus) {
+                manager.AddBus(query.bus, query.stops);
+            } else {
+                PrintQueryResponse(writer, manager, query);
+            }
+        }
+    }
+    
+    vector<Query> queries;
+    {
+        istringstream queries_input(input.str());
+        QueryReader reader(queries_input);
+        while (reader.Read(queries.emplace_back())) {
+        }
+        queries.pop_back();
+    }
+    assert(queries.size() == static_cast<size_t>(query_count));
+    
+    ostringstream output;
+    {
+        ResponseWriter writer(output);
+        ThreadPool pool(4);
+        BusManager manager;
+        ProcessQueriesInBatch(manager, queries, writer, pool, 4);
+    }
+    
+    assert(output.str() == expected.str());
+    
+    // Количество запросов берётся из ввода: огромное не резервирует память заранее,
+    // отрицательное отклоняется
+    {
+        istringstream huge_input("NEW_BUS 1 1 Center\nBUSES_FOR_STOP Center\n"s);
+        QueryReader reader(huge_input);
+        ostringstream huge_output;
+        {
+            ResponseWriter writer(huge_output);
+            ThreadPool pool(2);
+            ProcessQueriesInBatch(reader, numeric_limits<int>::max(), writer, pool);
+        }
+        assert(huge_output.str() == "1\n"s);
+        
+        istringstream negative_input("ALL_BUSES\n"s);
+        QueryReader negative_reader(negative_input);
+        ResponseWriter writer(huge_output);
+        ThreadPool pool(1);
+        try {
+            ProcessQueriesInBatch(negative_reader, -1, writer, pool);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+    }
 }
 
 static void RunTests() {
+    TestStringInterner();
+    
     TestQueryInputNewBus();
     TestQueryInputAllBuses();
     TestQueryInputStopsForBus();
     TestQueryInputBusesForStop();
+    TestQueryInputRoute();
+    
+    TestQueryReader();
+    TestQueryReaderErrors();
     
     TestOutputBusesForStop();
     TestOutputBusesForStopNoStop();
@@ -462,6 +938,8 @@ static void RunTests() {
     TestOutputAllBusesEmpty();
     TestOutputAllBuses();
     
+    TestResponseWriter();
+    
     TestGetBusesForStopNonExistentStop();
     TestGetBusesForStop();
     
@@ -470,6 +948,22 @@ static void RunTests() {
     
     TestGetAllBuses();
     TestGetAllBusesNoBuses();
+    
+    TestReAddBusReplacesRoute();
+    TestUpdateBus();
+    TestRemoveBus();
+    
+    TestGetRoute();
+    TestRouteIsShortest();
+    
+    TestSnapshot();
+    
+    TestConcurrentBusManager();
+    TestConcurrentBusManagerSnapshotLimits();
+    TestConcurrentBusManagerFailedChange();
+    
+    TestThreadPool();
+    TestBatchProcessing();
     cout << "all tests finished good" << endl;
 }
 
@@ -481,27 +975,37 @@ static void RunTests() {
 
 // original main
 
-int main() {
-    int query_count;
+// С ключом --batch запросы читаются целиком и запросы чтения выполняются параллельно
+int main(int argc, char* argv[]) {
+    QueryReader reader(cin);
+    ResponseWriter writer(cout);
     Query q;
 
-    cin >> query_count;
+    const int query_count = reader.ReadNumber<int>();
+
+    if (argc > 1 && argv[1] == "--batch"sv) {
+        ThreadPool pool(max(1u, thread::hardware_concurrency()));
+        ProcessQueriesInBatch(reader, query_count, writer, pool);
+        return 0;
+    }
 
     BusManager bm;
-    for (int i = 0; i < query_count; ++i) {
-        cin >> q;
+    for (int i = 0; i < query_count && reader.Read(q); ++i) {
         switch (q.type) {
             case QueryType::NewBus:
                 bm.AddBus(q.bus, q.stops);
                 break;
             case QueryType::BusesForStop:
-                cout << bm.GetBusesForStop(q.stop) << endl;
+                writer.Write(bm.GetBusesForStop(q.stop));
                 break;
             case QueryType::StopsForBus:
-                cout << bm.GetStopsForBus(q.bus) << endl;
+                writer.Write(bm.GetStopsForBus(q.bus));
                 break;
             case QueryType::AllBuses:
-                cout << bm.GetAllBuses() << endl;
+                writer.Write(bm.GetAllBuses());
+                break;
+            case QueryType::Route:
+                writer.Write(bm.GetRoute(q.stop, q.destination));
                 break;
         }
     }
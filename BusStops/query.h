@@ -0,0 +1,64 @@
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+enum class QueryType {
+    NewBus,
+    BusesForStop,
+    StopsForBus,
+    AllBuses,
+    Route,
+};
+
+struct Query {
+    QueryType type;
+    std::string bus;
+    std::string stop;
+    // Конечная остановка запроса ROUTE, начальная - stop
+    std::string destination;
+    std::vector<std::string> stops;
+};
+
+inline std::istream& operator>>(std::istream& is, Query& q) {
+    using namespace std::literals;
+
+    std::string operation_code;
+    is >> operation_code;
+
+    if (operation_code == "NEW_BUS"s) {
+        q.type = QueryType::NewBus;
+        
+        is >> q.bus;
+         
+        int stop_count;
+        
+        is >> stop_count;
+
+        q.stops.resize(stop_count);
+        
+        for (std::string& stop : q.stops) {
+            is >> stop;
+        }
+        
+    } else if (operation_code == "BUSES_FOR_STOP"s) {
+        q.type = QueryType::BusesForStop;
+        
+        is >> q.stop;
+        
+    } else if (operation_code == "STOPS_FOR_BUS"s) {
+        q.type = QueryType::StopsForBus;
+        
+        is >> q.bus;
+        
+    } else if (operation_code == "ALL_BUSES"s) {
+        q.type = QueryType::AllBuses;
+    } else if (operation_code == "ROUTE"s) {
+        q.type = QueryType::Route;
+        
+        is >> q.stop >> q.destination;
+    }
+    
+    return is;
+}
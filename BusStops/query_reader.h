@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "query.h"
+
+// Быстрое чтение запросов: ввод читается большими блоками в буфер, разбивается
+// на string_view-токены, числа разбираются через from_chars.
+// Строки Query переиспользуются между запросами, поэтому после прогрева
+// чтение запросов не выделяет память
+class QueryReader {
+public:
+    static constexpr size_t kDefaultBufferSize = 1 << 16;
+
+    explicit QueryReader(std::istream& input, size_t buffer_size = kDefaultBufferSize)
+    : input_(input)
+    , buffer_(std::max<size_t>(buffer_size, 1)) {
+    }
+
+    // Читает число, например количество запросов
+    template <typename Number>
+    Number ReadNumber() {
+        const std::string_view token = NextToken();
+        Number value{};
+        const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (token.empty() || error != std::errc{} || end != token.data() + token.size()) {
+            throw std::invalid_argument("expected a number, got \"" + std::string(token) + "\"");
+        }
+        return value;
+    }
+
+    // Читает очередной запрос в query. Возвращает false, если ввод закончился.
+    // Поля, не относящиеся к типу запроса, сохраняют значения от прошлых запросов
+    bool Read(Query& query) {
+        const std::string_view operation_code = NextToken();
+        if (operation_code.empty()) {
+            return false;
+        }
+
+        if (operation_code == "NEW_BUS") {
+            query.type = QueryType::NewBus;
+            ReadWord(query.bus);
+            // Количеству остановок из ввода не доверяем: вектор растёт по мере чтения,
+            // так что ошибочное число не приводит к огромному выделению памяти.
+            // Уже выделенные строки переиспользуются, assign сохраняет их память
+            const auto stop_count = ReadNumber<size_t>();
+            size_t read_count = 0;
+            for (; read_count < stop_count; ++read_count) {
+                if (read_count == query.stops.size()) {
+                    query.stops.emplace_back();
+                }
+                ReadWord(query.stops[read_count]);
+            }
+            query.stops.resize(read_count);
+        } else if (operation_code == "BUSES_FOR_STOP") {
+            query.type = QueryType::BusesForStop;
+            ReadWord(query.stop);
+        } else if (operation_code == "STOPS_FOR_BUS") {
+            query.type = QueryType::StopsForBus;
+            ReadWord(query.bus);
+        } else if (operation_code == "ALL_BUSES") {
+            query.type = QueryType::AllBuses;
+        } else if (operation_code == "ROUTE") {
+            query.type = QueryType::Route;
+            ReadWord(query.stop);
+            ReadWord(query.destination);
+        } else {
+            throw std::invalid_argument("unknown query \"" + std::string(operation_code) + "\"");
+        }
+
+        return true;
+    }
+
+private:
+    static bool IsSpace(char c) noexcept {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    void ReadWord(std::string& word) {
+        const std::string_view token = NextToken();
+        if (token.empty()) {
+            throw std::invalid_argument("unexpected end of input");
+        }
+        word.assign(token.data(), token.size());
+    }
+
+    // Возвращает следующий токен либо пустую строку в конце ввода.
+    // Токен указывает в буфер и действителен до следующего чтения
+    std::string_view NextToken() {
+        size_t start = pos_;
+        for (;;) {
+            while (pos_ < end_ && IsSpace(buffer_[pos_])) {
+                ++pos_;
+            }
+            if (pos_ < end_) {
+                break;
+            }
+            start = pos_;
+            if (!Refill(start)) {
+                return {};
+            }
+        }
+
+        start = pos_;
+        // Токен может продолжаться в следующем блоке ввода
+        while (true) {
+            while (pos_ < end_ && !IsSpace(buffer_[pos_])) {
+                ++pos_;
+            }
+            if (pos_ < end_ || !Refill(start)) {
+                break;
+            }
+        }
+
+        return {buffer_.data() + start, pos_ - start};
+    }
+
+    // Переносит данные начиная с keep в начало буфера и дочитывает ввод.
+    // Если буфер целиком занят одним токеном, он увеличивается вдвое.
+    // Возвращает false, если ввод закончился
+    bool Refill(size_t& keep) {
+        const size_t kept = end_ - keep;
+        std::memmove(buffer_.data(), buffer_.data() + keep, kept);
+        pos_ -= keep;
+        keep = 0;
+        end_ = kept;
+
+        if (end_ == buffer_.size()) {
+            buffer_.resize(2 * buffer_.size());
+        }
+
+        input_.read(buffer_.data() + end_, buffer_.size() - end_);
+        const auto count = static_cast<size_t>(input_.gcount());
+        end_ += count;
+
+        return count > 0;
+    }
+
+private:
+    std::istream& input_;
+    std::vector<char> buffer_;
+    // Непрочитанные данные буфера - [pos_, end_)
+    size_t pos_ = 0;
+    size_t end_ = 0;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Буферизованный вывод ответов: ответы накапливаются в строке и передаются
+// в поток крупными блоками, без сброса потока после каждого запроса.
+// Оставшиеся данные записываются при вызове Flush и в деструкторе
+class ResponseWriter {
+public:
+    static constexpr size_t kDefaultCapacity = 1 << 16;
+
+    explicit ResponseWriter(std::ostream& output, size_t capacity = kDefaultCapacity)
+    : output_(output)
+    , capacity_(capacity) {
+        buffer_.reserve(capacity_);
+    }
+
+    ResponseWriter(const ResponseWriter&) = delete;
+    ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+    ~ResponseWriter() {
+        Flush();
+    }
+
+    // Выводит ответ и перевод строки после него
+    template <typename Response>
+    void Write(const Response& response) {
+        PrintResponse(*this, response);
+        *this << '\n';
+    }
+
+    ResponseWriter& operator<<(std::string_view text) {
+        if (buffer_.size() + text.size() > capacity_) {
+            WriteBuffer();
+        }
+        if (text.size() >= capacity_) {
+            // Большой блок, например готовую часть ответов, пишем без копирования в буфер
+            output_.write(text.data(), static_cast<std::streamsize>(text.size()));
+        } else {
+            buffer_.append(text);
+        }
+        return *this;
+    }
+
+    ResponseWriter& operator<<(char c) {
+        if (buffer_.size() == capacity_) {
+            WriteBuffer();
+        }
+        buffer_.push_back(c);
+        return *this;
+    }
+
+    void Flush() {
+        WriteBuffer();
+        output_.flush();
+    }
+
+private:
+    void WriteBuffer() {
+        if (!buffer_.empty()) {
+            output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+    }
+
+private:
+    std::ostream& output_;
+    size_t capacity_;
+    std::string buffer_;
+};
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "string_interner.h"
+
+// Поиск маршрута с наименьшим числом пересадок.
+// Сеть - двудольный граф: остановка связана с автобусами, которые через неё проходят,
+// автобус - со всеми остановками маршрута. Проехать на автобусе можно между любыми
+// двумя его остановками, поэтому длина пути в автобусах на единицу больше числа пересадок
+namespace route_search {
+
+using Id = StringInterner::Id;
+using Lists = std::vector<std::vector<Id>>;
+
+inline constexpr Id kNoId = std::numeric_limits<Id>::max();
+
+// Поездка на автобусе bus до остановки stop
+struct RouteLeg {
+    Id bus;
+    Id stop;
+};
+
+// Рабочие массивы поиска. Метки с номером поиска не нужно очищать между
+// запросами, поэтому поиск не проходит всю сеть, а только посещённую часть
+class SearchState {
+public:
+    // Готовит массивы к новому поиску по сети из stop_count остановок и bus_count автобусов
+    void Start(size_t stop_count, size_t bus_count) {
+        for (Side& side : sides_) {
+            if (side.stops.size() < stop_count) {
+                side.stops.resize(stop_count);
+            }
+            if (side.buses.size() < bus_count) {
+                side.buses.resize(bus_count);
+            }
+        }
+        if (++search_ == 0) {
+            // Номера поисков исчерпаны, старые метки могли бы совпасть с новыми
+            for (Side& side : sides_) {
+                std::fill(side.stops.begin(), side.stops.end(), StopMark{});
+                std::fill(side.buses.begin(), side.buses.end(), BusMark{});
+            }
+            search_ = 1;
+        }
+    }
+
+    bool IsVisitedStop(int side, Id stop) const noexcept {
+        return sides_[side].stops[stop].search == search_;
+    }
+
+    bool IsVisitedBus(int side, Id bus) const noexcept {
+        return sides_[side].buses[bus].search == search_;
+    }
+
+    void VisitStop(int side, Id stop, Id parent_bus, std::uint32_t bus_count) noexcept {
+        sides_[side].stops[stop] = {search_, parent_bus, bus_count};
+    }
+
+    void VisitBus(int side, Id bus, Id parent_stop) noexcept {
+        sides_[side].buses[bus] = {search_, parent_stop};
+    }
+
+    Id GetParentBus(int side, Id stop) const noexcept {
+        return sides_[side].stops[stop].parent_bus;
+    }
+
+    Id GetParentStop(int side, Id bus) const noexcept {
+        return sides_[side].buses[bus].parent_stop;
+    }
+
+    // Сколько автобусов нужно, чтобы добраться до остановки с этой стороны
+    std::uint32_t GetBusCount(int side, Id stop) const noexcept {
+        return sides_[side].stops[stop].bus_count;
+    }
+
+    std::vector<Id>& GetFrontier(int side) noexcept {
+        return sides_[side].frontier;
+    }
+
+    std::vector<Id>& GetNextFrontier() noexcept {
+        return next_frontier_;
+    }
+
+private:
+    struct StopMark {
+        std::uint32_t search = 0;
+        Id parent_bus = kNoId;
+        std::uint32_t bus_count = 0;
+    };
+
+    struct BusMark {
+        std::uint32_t search = 0;
+        Id parent_stop = kNoId;
+    };
+
+    // Поиск идёт с двух сторон: 0 - от начальной остановки, 1 - от конечной
+    struct Side {
+        std::vector<StopMark> stops;
+        std::vector<BusMark> buses;
+        std::vector<Id> frontier;
+    };
+
+    Side sides_[2];
+    std::vector<Id> next_frontier_;
+    std::uint32_t search_ = 0;
+};
+
+// Массивы поиска свои у каждого потока, так что константный BusManager
+// можно опрашивать из нескольких потоков
+inline SearchState& GetThreadSearchState() {
+    static thread_local SearchState state;
+    return state;
+}
+
+// Двунаправленный поиск в ширину. За шаг одна из сторон, у которой меньше фронт,
+// проезжает ещё на одном автобусе. Шаг доводится до конца, и из найденных на нём
+// встреч сторон выбирается лучшая: все более короткие пути нашлись бы раньше.
+// Возвращает поездки от from до to либо nullopt, если добраться нельзя
+inline std::optional<std::vector<RouteLeg>> FindRoute(const Lists& bus_to_stops, const Lists& stop_to_buses,
+                                                      Id from, Id to) {
+    if (from == to) {
+        return std::vector<RouteLeg>{};
+    }
+
+    SearchState& state = GetThreadSearchState();
+    state.Start(stop_to_buses.size(), bus_to_stops.size());
+
+    const Id ends[2] = {from, to};
+    for (int side = 0; side < 2; ++side) {
+        state.VisitStop(side, ends[side], kNoId, 0);
+        state.GetFrontier(side).assign(1, ends[side]);
+    }
+
+    Id meeting_stop = kNoId;
+    std::uint32_t best_bus_count = std::numeric_limits<std::uint32_t>::max();
+    while (meeting_stop == kNoId && !state.GetFrontier(0).empty() && !state.GetFrontier(1).empty()) {
+        const int side = state.GetFrontier(0).size() <= state.GetFrontier(1).size() ? 0 : 1;
+        const int other_side = 1 - side;
+
+        std::vector<Id>& next_frontier = state.GetNextFrontier();
+        next_frontier.clear();
+        for (Id stop : state.GetFrontier(side)) {
+            const std::uint32_t bus_count = state.GetBusCount(side, stop) + 1;
+            for (Id bus : stop_to_buses[stop]) {
+                if (state.IsVisitedBus(side, bus)) {
+                    continue;
+                }
+                state.VisitBus(side, bus, stop);
+
+                for (Id next_stop : bus_to_stops[bus]) {
+                    if (state.IsVisitedStop(side, next_stop)) {
+                        continue;
+                    }
+                    state.VisitStop(side, next_stop, bus, bus_count);
+                    next_frontier.push_back(next_stop);
+
+                    if (state.IsVisitedStop(other_side, next_stop)
+                        && bus_count + state.GetBusCount(other_side, next_stop) < best_bus_count) {
+                        best_bus_count = bus_count + state.GetBusCount(other_side, next_stop);
+                        meeting_stop = next_stop;
+                    }
+                }
+            }
+        }
+        std::swap(state.GetFrontier(side), next_frontier);
+    }
+
+    if (meeting_stop == kNoId) {
+        return std::nullopt;
+    }
+
+    // Путь от from до встречи восстанавливается с конца, от встречи до to - с начала
+    std::vector<RouteLeg> legs;
+    for (Id stop = meeting_stop; stop != from; ) {
+        const Id bus = state.GetParentBus(0, stop);
+        legs.push_back({bus, stop});
+        stop = state.GetParentStop(0, bus);
+    }
+    std::reverse(legs.begin(), legs.end());
+    for (Id stop = meeting_stop; stop != to; ) {
+        const Id bus = state.GetParentBus(1, stop);
+        stop = state.GetParentStop(1, bus);
+        legs.push_back({bus, stop});
+    }
+    return legs;
+}
+
+// Заранее посчитанные деревья поиска в ширину от узловых остановок - тех,
+// через которые проходит больше всего автобусов. Маршрут, начинающийся или
+// заканчивающийся на узловой остановке, читается из дерева без поиска.
+// Памяти нужно O(узлы * (остановки + автобусы))
+class TransferTable {
+public:
+    TransferTable() = default;
+
+    TransferTable(const Lists& bus_to_stops, const Lists& stop_to_buses, size_t hub_count) {
+        std::vector<Id> stops(stop_to_buses.size());
+        for (Id stop = 0; stop < stops.size(); ++stop) {
+            stops[stop] = stop;
+        }
+        hub_count = std::min(hub_count, stops.size());
+        std::partial_sort(stops.begin(), stops.begin() + hub_count, stops.end(), [&stop_to_buses](Id left, Id right) {
+            return std::pair(stop_to_buses[left].size(), right) > std::pair(stop_to_buses[right].size(), left);
+        });
+
+        hub_index_.assign(stop_to_buses.size(), kNoId);
+        for (size_t i = 0; i < hub_count && !stop_to_buses[stops[i]].empty(); ++i) {
+            hub_index_[stops[i]] = static_cast<Id>(hubs_.size());
+            hubs_.push_back(BuildTree(bus_to_stops, stop_to_buses, stops[i]));
+        }
+    }
+
+    size_t GetHubCount() const noexcept {
+        return hubs_.size();
+    }
+
+    // Можно ли ответить на запрос по таблице
+    bool HasRoute(Id from, Id to) const noexcept {
+        return IsHub(from) || IsHub(to);
+    }
+
+    // Маршрут для запроса, на который можно ответить по таблице, см. HasRoute
+    std::optional<std::vector<RouteLeg>> FindRoute(Id from, Id to) const {
+        std::vector<RouteLeg> legs;
+        if (IsHub(to)) {
+            // Дерево ведёт от остановки к узлу, то есть в нужную сторону
+            const Tree& tree = hubs_[hub_index_[to]];
+            if (!tree.IsReached(from)) {
+                return std::nullopt;
+            }
+            for (Id stop = from; stop != tree.root; ) {
+                const Id bus = tree.stop_parent_buses[stop];
+                stop = tree.bus_parent_stops[bus];
+                legs.push_back({bus, stop});
+            }
+        } else {
+            const Tree& tree = hubs_[hub_index_[from]];
+            if (!tree.IsReached(to)) {
+                return std::nullopt;
+            }
+            for (Id stop = to; stop != tree.root; ) {
+                const Id bus = tree.stop_parent_buses[stop];
+                legs.push_back({bus, stop});
+                stop = tree.bus_parent_stops[bus];
+            }
+            std::reverse(legs.begin(), legs.end());
+        }
+        return legs;
+    }
+
+private:
+    // Дерево поиска в ширину от root: для остановки - автобус, на котором до неё
+    // доехали, для автобуса - остановка, где на него сели
+    struct Tree {
+        Id root = kNoId;
+        std::vector<Id> stop_parent_buses;
+        std::vector<Id> bus_parent_stops;
+
+        bool IsReached(Id stop) const noexcept {
+            return stop == root || stop_parent_buses[stop] != kNoId;
+        }
+    };
+
+    bool IsHub(Id stop) const noexcept {
+        return stop < hub_index_.size() && hub_index_[stop] != kNoId;
+    }
+
+    static Tree BuildTree(const Lists& bus_to_stops, const Lists& stop_to_buses, Id root) {
+        Tree tree;
+        tree.root = root;
+        tree.stop_parent_buses.assign(stop_to_buses.size(), kNoId);
+        tree.bus_parent_stops.assign(bus_to_stops.size(), kNoId);
+
+        std::vector<Id> queue{root};
+        for (size_t i = 0; i < queue.size(); ++i) {
+            const Id stop = queue[i];
+            for (Id bus : stop_to_buses[stop]) {
+                if (tree.bus_parent_stops[bus] != kNoId) {
+                    continue;
+                }
+                tree.bus_parent_stops[bus] = stop;
+                for (Id next_stop : bus_to_stops[bus]) {
+                    if (tree.IsReached(next_stop)) {
+                        continue;
+                    }
+                    tree.stop_parent_buses[next_stop] = bus;
+                    queue.push_back(next_stop);
+                }
+            }
+        }
+        return tree;
+    }
+
+private:
+    std::vector<Tree> hubs_;
+    // Номер дерева для узловой остановки, kNoId для остальных
+    std::vector<Id> hub_index_;
+};
+
+} // namespace route_search
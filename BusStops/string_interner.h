@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Сопоставляет строкам плотные целочисленные идентификаторы 0, 1, 2, ...
+// Каждая строка хранится один раз, идентификатор можно перевести обратно в имя.
+// Индекс имён - хэш-таблица с открытой адресацией и линейным пробированием:
+// поиск по string_view не создаёт временных строк и проходит таблицу один раз
+class StringInterner {
+public:
+    using Id = std::uint32_t;
+
+    // Возвращает идентификатор name, добавляя строку при первом обращении
+    Id Intern(std::string_view name) {
+        // Таблица заполнена не больше чем наполовину, поэтому цепочки пробирования короткие
+        if (2 * (names_.size() + 1) > slots_.size()) {
+            Rehash(slots_.empty() ? kInitialCapacity : 2 * slots_.size());
+        }
+
+        const std::uint32_t hash = Hash(name);
+        Slot& slot = slots_[FindSlot(name, hash)];
+        if (slot.id != kNoId) {
+            return slot.id;
+        }
+
+        const auto id = static_cast<Id>(names_.size());
+        // deque не перемещает элементы при добавлении, поэтому string_view на них остаются валидными
+        names_.emplace_back(name);
+        slot = {hash, id};
+
+        return id;
+    }
+
+    // Готовит индекс к count строкам, чтобы добавление не перестраивало его
+    void Reserve(size_t count) {
+        size_t capacity = slots_.empty() ? kInitialCapacity : slots_.size();
+        while (2 * count > capacity) {
+            capacity *= 2;
+        }
+        if (capacity != slots_.size()) {
+            Rehash(capacity);
+        }
+    }
+
+    std::optional<Id> Find(std::string_view name) const {
+        if (slots_.empty()) {
+            return std::nullopt;
+        }
+
+        const Id id = slots_[FindSlot(name, Hash(name))].id;
+        if (id == kNoId) {
+            return std::nullopt;
+        }
+        return id;
+    }
+
+    std::string_view GetName(Id id) const {
+        return names_.at(id);
+    }
+
+    size_t GetSize() const noexcept {
+        return names_.size();
+    }
+
+private:
+    static constexpr Id kNoId = std::numeric_limits<Id>::max();
+    static constexpr size_t kInitialCapacity = 16;
+
+    struct Slot {
+        // Младшие биты хэша задают начальную ячейку, полный хэш отсекает
+        // большинство несовпадений без сравнения строк
+        std::uint32_t hash = 0;
+        Id id = kNoId;
+    };
+
+    static std::uint32_t Hash(std::string_view name) {
+        const std::uint64_t hash = std::hash<std::string_view>{}(name);
+        return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+    }
+
+    // Возвращает ячейку со строкой name либо первую пустую ячейку на её цепочке
+    size_t FindSlot(std::string_view name, std::uint32_t hash) const {
+        const size_t mask = slots_.size() - 1;
+        for (size_t index = hash & mask;; index = (index + 1) & mask) {
+            const Slot& slot = slots_[index];
+            if (slot.id == kNoId || (slot.hash == hash && names_[slot.id] == name)) {
+                return index;
+            }
+        }
+    }
+
+    // capacity - степень двойки
+    void Rehash(size_t capacity) {
+        std::vector<Slot> slots(capacity);
+        const size_t mask = capacity - 1;
+        for (const Slot& slot : slots_) {
+            if (slot.id == kNoId) {
+                continue;
+            }
+            size_t index = slot.hash & mask;
+            while (slots[index].id != kNoId) {
+                index = (index + 1) & mask;
+            }
+            slots[index] = slot;
+        }
+        slots_.swap(slots);
+    }
+
+private:
+    std::deque<std::string> names_;
+    std::vector<Slot> slots_;
+};
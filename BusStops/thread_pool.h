@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков для параллельного выполнения набора независимых задач.
+// Run раздаёт задачи 0..task_count-1 потокам пула и вызывающему потоку
+// и возвращает управление, когда выполнены все задачи
+class ThreadPool {
+public:
+    // thread_count - общее количество потоков, включая вызывающий Run.
+    // Если поток не удалось создать, уже запущенные потоки останавливаются
+    // и исключение передаётся дальше
+    explicit ThreadPool(size_t thread_count) {
+        try {
+            workers_.reserve(thread_count > 0 ? thread_count - 1 : 0);
+            for (size_t i = 1; i < thread_count; ++i) {
+                workers_.emplace_back([this] {
+                    WorkerLoop();
+                });
+            }
+        } catch (...) {
+            // Деструктор не вызывается для недостроенного объекта, а разрушение
+            // работающих std::thread завершило бы программу
+            StopWorkers();
+            throw;
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        StopWorkers();
+    }
+
+    size_t GetThreadCount() const noexcept {
+        return workers_.size() + 1;
+    }
+
+    // Вызывает task(index) для каждого index из [0, task_count).
+    // Если задачи выбросили исключения, после завершения остальных
+    // задач выбрасывается первое из них
+    template <typename Task>
+    void Run(size_t task_count, Task&& task) {
+        if (workers_.empty() || task_count <= 1) {
+            for (size_t index = 0; index < task_count; ++index) {
+                task(index);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard guard(mutex_);
+            task_ = [&task](size_t index) {
+                task(index);
+            };
+            task_count_ = task_count;
+            next_task_ = 0;
+            error_ = nullptr;
+            busy_workers_ = workers_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        RunTasks();
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] {
+            return busy_workers_ == 0;
+        });
+        task_ = nullptr;
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    void StopWorkers() noexcept {
+        {
+            std::lock_guard guard(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void WorkerLoop() {
+        size_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [this, seen_generation] {
+                    return stop_ || generation_ != seen_generation;
+                });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+            }
+
+            RunTasks();
+
+            std::lock_guard guard(mutex_);
+            if (--busy_workers_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    void RunTasks() {
+        for (size_t index = next_task_++; index < task_count_; index = next_task_++) {
+            try {
+                task_(index);
+            } catch (...) {
+                std::lock_guard guard(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+private:
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    bool stop_ = false;
+    // Номер текущего вызова Run, по его смене рабочие потоки узнают о новых задачах
+    size_t generation_ = 0;
+    size_t busy_workers_ = 0;
+
+    std::function<void(size_t)> task_;
+    size_t task_count_ = 0;
+    std::atomic<size_t> next_task_ = 0;
+    std::exception_ptr error_;
+};
@@ -0,0 +1,400 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bus_manager.h"
+#include "concurrent_bus_manager.h"
+#include "log_duration.h"
+#include "query.h"
+#include "query_reader.h"
+
+using namespace std;
+
+struct MapBusesForStopResponse {
+    vector<string> buses;
+};
+
+struct MapStopsForBusResponse {
+    string bus;
+    vector<pair<string, vector<string>>> stops_to_buses;
+};
+
+// Вывод ответов в исходном формате, как у BusManager
+template <typename Output>
+void PrintResponse(Output& out, const MapBusesForStopResponse& r) {
+    if (r.buses.empty()) {
+        out << "No stop"sv;
+        return;
+    }
+    bool isFirst = true;
+    for (const string& bus : r.buses) {
+        if (!isFirst) {
+            out << ' ';
+        }
+        isFirst = false;
+        out << bus;
+    }
+}
+
+template <typename Output>
+void PrintResponse(Output& out, const MapStopsForBusResponse& r) {
+    if (r.stops_to_buses.empty()) {
+        out << "No bus"sv;
+        return;
+    }
+    bool isFirstLine = true;
+    for (const auto& [stop, buses] : r.stops_to_buses) {
+        if (!isFirstLine) {
+            out << '\n';
+        }
+        isFirstLine = false;
+
+        out << "Stop "sv << stop << ": "sv;
+        if (buses.size() == 1) {
+            out << "no interchange"sv;
+            continue;
+        }
+        bool isFirstBus = true;
+        for (const string& other_bus : buses) {
+            if (r.bus != other_bus) {
+                if (!isFirstBus) {
+                    out << ' ';
+                }
+                isFirstBus = false;
+                out << other_bus;
+            }
+        }
+    }
+}
+
+// Приёмник выводимых ответов: текст дописывается в строку, память которой
+// переиспользуется между запросами, так что измеряется именно вывод
+struct ResponseSink {
+    string text;
+
+    ResponseSink& operator<<(string_view value) {
+        text.append(value);
+        return *this;
+    }
+
+    ResponseSink& operator<<(char value) {
+        text.push_back(value);
+        return *this;
+    }
+
+    // Выводит ответ и возвращает длину его текста
+    template <typename Response>
+    size_t Render(const Response& response) {
+        text.clear();
+        PrintResponse(*this, response);
+        return text.size();
+    }
+};
+
+// Исходная реализация на std::map: строки хранятся в каждом индексе,
+// поиск - count() и at() по дереву со сравнением строк, ответы копируют данные
+class MapBusManager {
+public:
+    void AddBus(const string& bus, const vector<string>& stops) {
+        buses_to_stops_[bus] = stops;
+        for (const string& stop : stops) {
+            stops_to_buses_[stop].push_back(bus);
+        }
+    }
+
+    MapBusesForStopResponse GetBusesForStop(const string& stop) const {
+        MapBusesForStopResponse response;
+
+        if (stops_to_buses_.count(stop) == 0) {
+            return response;
+        }
+
+        response.buses = stops_to_buses_.at(stop);
+
+        return response;
+    }
+
+    MapStopsForBusResponse GetStopsForBus(const string& bus) const {
+        MapStopsForBusResponse response;
+
+        if (buses_to_stops_.count(bus) == 0) {
+            return response;
+        }
+
+        response.bus = bus;
+
+        for (const string& stop : buses_to_stops_.at(bus)) {
+            response.stops_to_buses.push_back({stop, stops_to_buses_.at(stop)});
+        }
+
+        return response;
+    }
+
+private:
+    map<string, vector<string>> buses_to_stops_, stops_to_buses_;
+};
+
+struct Network {
+    vector<string> buses;
+    vector<vector<string>> routes;
+    vector<string> stops;
+};
+
+// Город из bus_count маршрутов по route_length остановок, выбранных из stop_count остановок
+Network MakeNetwork(int bus_count, int stop_count, int route_length) {
+    mt19937 generator{42};
+    uniform_int_distribution<int> stop_distribution(0, stop_count - 1);
+
+    Network network;
+    for (int i = 0; i < stop_count; ++i) {
+        network.stops.push_back("Stop"s + to_string(i));
+    }
+    for (int i = 0; i < bus_count; ++i) {
+        network.buses.push_back("Bus"s + to_string(i));
+        vector<string>& route = network.routes.emplace_back();
+        for (int j = 0; j < route_length; ++j) {
+            route.push_back(network.stops[stop_distribution(generator)]);
+        }
+    }
+    return network;
+}
+
+// Запросы к существующим и несуществующим остановкам и автобусам вперемешку
+vector<pair<bool, string>> MakeQueries(const Network& network, int query_count) {
+    mt19937 generator{7};
+    uniform_int_distribution<int> kind_distribution(0, 9);
+
+    vector<pair<bool, string>> queries;
+    queries.reserve(query_count);
+    for (int i = 0; i < query_count; ++i) {
+        const int kind = kind_distribution(generator);
+        if (kind < 6) {
+            const auto& stop = network.stops[generator() % network.stops.size()];
+            queries.emplace_back(true, kind == 0 ? stop + "X"s : stop);
+        } else {
+            const auto& bus = network.buses[generator() % network.buses.size()];
+            queries.emplace_back(false, kind == 6 ? bus + "X"s : bus);
+        }
+    }
+    return queries;
+}
+
+template <typename Manager>
+void Measure(const string& name, const Network& network, const vector<pair<bool, string>>& queries) {
+    Manager manager;
+    {
+        LOG_DURATION(name + " AddBus"s);
+        for (size_t i = 0; i < network.buses.size(); ++i) {
+            manager.AddBus(network.buses[i], network.routes[i]);
+        }
+    }
+
+    // Ответы выводятся: иначе представления BusManager сравнивались бы
+    // с копированием ответов std::map без их вывода
+    ResponseSink sink;
+    size_t result = 0;
+    const auto start_time = chrono::steady_clock::now();
+    {
+        LOG_DURATION(name + " queries"s);
+        for (const auto& [is_stop_query, query] : queries) {
+            if (is_stop_query) {
+                result += sink.Render(manager.GetBusesForStop(query));
+            } else {
+                result += sink.Render(manager.GetStopsForBus(query));
+            }
+        }
+    }
+    const chrono::duration<double> seconds = chrono::steady_clock::now() - start_time;
+
+    cerr << "  qps: "s << static_cast<long long>(queries.size() / seconds.count())
+         << ", result: "s << result << endl;
+}
+
+// Запросы делятся поровну между thread_count читателями, каждый запрос
+// выполняется на свежем снимке ConcurrentBusManager
+void MeasureConcurrentReads(const Network& network, const vector<pair<bool, string>>& queries, int thread_count) {
+    ConcurrentBusManager manager;
+    for (size_t i = 0; i < network.buses.size(); ++i) {
+        manager.AddBus(network.buses[i], network.routes[i]);
+    }
+
+    vector<size_t> results(thread_count);
+    const auto start_time = chrono::steady_clock::now();
+    {
+        LOG_DURATION("ConcurrentBusManager queries, threads: "s + to_string(thread_count));
+        vector<thread> readers;
+        for (int t = 0; t < thread_count; ++t) {
+            readers.emplace_back([&, t] {
+                ResponseSink sink;
+                for (size_t i = t; i < queries.size(); i += thread_count) {
+                    const auto snapshot = manager.GetSnapshot();
+                    const auto& [is_stop_query, query] = queries[i];
+                    if (is_stop_query) {
+                        results[t] += sink.Render(snapshot->GetBusesForStop(query));
+                    } else {
+                        results[t] += sink.Render(snapshot->GetStopsForBus(query));
+                    }
+                }
+            });
+        }
+        for (thread& reader : readers) {
+            reader.join();
+        }
+    }
+    const chrono::duration<double> seconds = chrono::steady_clock::now() - start_time;
+
+    size_t result = 0;
+    for (size_t thread_result : results) {
+        result += thread_result;
+    }
+    cerr << "  qps: "s << static_cast<long long>(queries.size() / seconds.count())
+         << ", result: "s << result << endl;
+}
+
+// Холодный старт: повтор всех AddBus против загрузки двоичного снимка
+void MeasureSnapshot(const Network& network) {
+    BusManager manager;
+    {
+        LOG_DURATION("cold start by AddBus replay"s);
+        for (size_t i = 0; i < network.buses.size(); ++i) {
+            manager.AddBus(network.buses[i], network.routes[i]);
+        }
+    }
+
+    ostringstream output;
+    manager.SaveSnapshot(output);
+    const string snapshot = output.str();
+
+    size_t result = 0;
+    {
+        LOG_DURATION("cold start by LoadSnapshot"s);
+        result = BusManager::LoadSnapshot(snapshot).GetAllBuses().buses_to_stops.size();
+    }
+    cerr << "  snapshot bytes: "s << snapshot.size() << ", result: "s << result << endl;
+}
+
+// Маршруты между случайными остановками, затем от случайных остановок до узловых
+// без таблицы и с таблицей пересадок
+void MeasureRoutes(const Network& network, int query_count) {
+    BusManager manager;
+    for (size_t i = 0; i < network.buses.size(); ++i) {
+        manager.AddBus(network.buses[i], network.routes[i]);
+    }
+
+    mt19937 generator{11};
+    vector<pair<string, string>> random_pairs;
+    for (int i = 0; i < query_count; ++i) {
+        random_pairs.emplace_back(network.stops[generator() % network.stops.size()],
+                                  network.stops[generator() % network.stops.size()]);
+    }
+
+    constexpr size_t hub_count = 16;
+    vector<pair<size_t, string>> stops_by_buses;
+    for (const string& stop : network.stops) {
+        stops_by_buses.emplace_back(manager.GetBusesForStop(stop).buses.size(), stop);
+    }
+    sort(stops_by_buses.rbegin(), stops_by_buses.rend());
+    vector<pair<string, string>> hub_pairs;
+    for (int i = 0; i < query_count; ++i) {
+        hub_pairs.emplace_back(network.stops[generator() % network.stops.size()],
+                               stops_by_buses[generator() % (hub_count / 2)].second);
+    }
+
+    const auto measure = [&manager](const string& name, const vector<pair<string, string>>& pairs) {
+        size_t result = 0;
+        const auto start_time = chrono::steady_clock::now();
+        {
+            LOG_DURATION(name);
+            for (const auto& [from, to] : pairs) {
+                result += manager.GetRoute(from, to).legs.size();
+            }
+        }
+        const chrono::duration<double> seconds = chrono::steady_clock::now() - start_time;
+        cerr << "  us per route: "s << seconds.count() * 1e6 / pairs.size() << ", result: "s << result << endl;
+    };
+
+    measure("ROUTE between random stops"s, random_pairs);
+    measure("ROUTE to hubs by search"s, hub_pairs);
+    {
+        LOG_DURATION("BuildTransferTable"s);
+        manager.BuildTransferTable(hub_count);
+    }
+    measure("ROUTE to hubs by transfer table"s, hub_pairs);
+}
+
+// Текст входных данных: сначала все маршруты, затем запросы
+string MakeInput(const Network& network, const vector<pair<bool, string>>& queries) {
+    ostringstream output;
+    output << network.buses.size() + queries.size() << '\n';
+    for (size_t i = 0; i < network.buses.size(); ++i) {
+        output << "NEW_BUS "s << network.buses[i] << ' ' << network.routes[i].size();
+        for (const string& stop : network.routes[i]) {
+            output << ' ' << stop;
+        }
+        output << '\n';
+    }
+    for (const auto& [is_stop_query, query] : queries) {
+        output << (is_stop_query ? "BUSES_FOR_STOP "s : "STOPS_FOR_BUS "s) << query << '\n';
+    }
+    return output.str();
+}
+
+template <typename ReadFunction>
+void MeasureParsing(const string& name, const string& text, ReadFunction read) {
+    istringstream input(text);
+    size_t result = 0;
+    const auto start_time = chrono::steady_clock::now();
+    {
+        LOG_DURATION(name);
+        result = read(input);
+    }
+    const chrono::duration<double> seconds = chrono::steady_clock::now() - start_time;
+
+    cerr << "  MB/s: "s << static_cast<long long>(text.size() / seconds.count() / 1e6)
+         << ", result: "s << result << endl;
+}
+
+int main() {
+    const Network network = MakeNetwork(20'000, 100'000, 20);
+    const auto queries = MakeQueries(network, 500'000);
+
+    Measure<MapBusManager>("std::map BusManager"s, network, queries);
+    Measure<BusManager>("BusManager"s, network, queries);
+    MeasureSnapshot(network);
+
+    for (int thread_count : {1, 2, 4}) {
+        MeasureConcurrentReads(network, queries, thread_count);
+    }
+
+    MeasureRoutes(network, 10'000);
+
+    const string text = MakeInput(network, queries);
+    MeasureParsing("operator>> parsing"s, text, [](istream& input) {
+        int query_count;
+        input >> query_count;
+        Query query;
+        size_t result = 0;
+        for (int i = 0; i < query_count; ++i) {
+            input >> query;
+            result += query.type == QueryType::NewBus ? query.stops.size() : 1;
+        }
+        return result;
+    });
+    MeasureParsing("QueryReader parsing"s, text, [](istream& input) {
+        QueryReader reader(input);
+        const int query_count = reader.ReadNumber<int>();
+        Query query;
+        size_t result = 0;
+        for (int i = 0; i < query_count && reader.Read(query); ++i) {
+            result += query.type == QueryType::NewBus ? query.stops.size() : 1;
+        }
+        return result;
+    });
+}
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <forward_list>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "list.h"
+#include "log_duration.h"
+#include "unrolled_list.h"
+
+using namespace std;
+
+// Порядок размещения узлов в памяти
+enum class Layout {
+    // Соседние элементы списка лежат в соседних узлах
+    Sequential,
+    // Порядок обхода не совпадает с порядком узлов в памяти
+    Shuffled,
+};
+
+string ToString(Layout layout) {
+    return layout == Layout::Sequential ? "sequential"s : "shuffled"s;
+}
+
+// Значения 0..size-1; для Layout::Shuffled они перемешаны, чтобы после
+// сортировки списка соседние элементы оказались в случайных местах памяти
+vector<int> MakeValues(int size, Layout layout) {
+    vector<int> values(size);
+    iota(values.begin(), values.end(), 0);
+    if (layout == Layout::Shuffled) {
+        shuffle(values.begin(), values.end(), mt19937{42});
+    }
+    return values;
+}
+
+template <typename List>
+List MakeList(const vector<int>& values) {
+    if constexpr (is_same_v<List, vector<int>> || is_same_v<List, forward_list<int>>) {
+        return List(values.begin(), values.end());
+    } else {
+        List list;
+        auto last = list.before_begin();
+        for (int value : values) {
+            last = list.InsertAfter(last, value);
+        }
+        return list;
+    }
+}
+
+// Сортировка перевязывает узлы и не перемещает их в памяти
+void SortNodes(SingleLinkedList<int>& list) {
+    list.Sort();
+}
+
+void SortNodes(forward_list<int>& list) {
+    list.sort();
+}
+
+template <typename List>
+List MakeList(int size, Layout layout) {
+    List list = MakeList<List>(MakeValues(size, layout));
+    if (layout == Layout::Shuffled) {
+        SortNodes(list);
+    }
+    return list;
+}
+
+template <typename Container>
+long long Traverse(const Container& container, int repeat_count) {
+    long long sum = 0;
+    for (int r = 0; r < repeat_count; ++r) {
+        sum = accumulate(container.begin(), container.end(), sum);
+    }
+    return sum;
+}
+
+long long TraversePrefetching(const SingleLinkedList<int>& list, int repeat_count) {
+    long long sum = 0;
+    for (int r = 0; r < repeat_count; ++r) {
+        sum = accumulate(list.PrefetchingBegin(), list.PrefetchingEnd(), sum);
+    }
+    return sum;
+}
+
+template <typename Container, typename Function>
+void Measure(const string& name, const Container& container, Function function) {
+    long long result = 0;
+    {
+        LOG_DURATION(name);
+        result = function(container);
+    }
+    cerr << "  result: "s << result << endl;
+}
+
+int main() {
+    // Общее количество посещённых элементов одинаково для всех размеров
+    const int total_elements = 20'000'000;
+
+    for (int size : {1'000, 100'000, 2'000'000}) {
+        const int repeat_count = total_elements / size;
+        const auto traverse = [repeat_count](const auto& container) {
+            return Traverse(container, repeat_count);
+        };
+        const string suffix = " size "s + to_string(size);
+
+        Measure("vector"s + suffix, MakeList<vector<int>>(MakeValues(size, Layout::Sequential)), traverse);
+        Measure("UnrolledSingleLinkedList"s + suffix,
+                MakeList<UnrolledSingleLinkedList<int>>(MakeValues(size, Layout::Sequential)), traverse);
+
+        for (Layout layout : {Layout::Sequential, Layout::Shuffled}) {
+            const string name_suffix = suffix + " "s + ToString(layout);
+
+            Measure("forward_list"s + name_suffix, MakeList<forward_list<int>>(size, layout), traverse);
+
+            const auto list = MakeList<SingleLinkedList<int>>(size, layout);
+            Measure("SingleLinkedList"s + name_suffix, list, traverse);
+            Measure("SingleLinkedList prefetching"s + name_suffix, list, [repeat_count](const auto& container) {
+                return TraversePrefetching(container, repeat_count);
+            });
+
+            // Сравнение двух равных списков проходит оба списка целиком
+            const auto other = MakeList<SingleLinkedList<int>>(size, layout);
+            const int compare_count = max(1, repeat_count / 2);
+            Measure("operator=="s + name_suffix, list, [&other, compare_count](const auto& container) {
+                long long equal_count = 0;
+                for (int r = 0; r < compare_count; ++r) {
+                    equal_count += container == other;
+                }
+                return equal_count;
+            });
+            Measure("PrefetchingEqual"s + name_suffix, list, [&other, compare_count](const auto& container) {
+                long long equal_count = 0;
+                for (int r = 0; r < compare_count; ++r) {
+                    equal_count += PrefetchingEqual(container, other);
+                }
+                return equal_count;
+            });
+        }
+    }
+}
@@ -5,6 +5,7 @@
 
 #include "ptr_vector.h"
 #include "scoped_pointer.h"
+#include "tentacle_table.h"
 
 using namespace std;
 
@@ -173,6 +174,41 @@ int main() {
         assert(male.GetTentacle(0).GetLinkedTentacle() == nullptr);
     }
 
+    // Таблица щупалец хранит связи индексами, копия таблицы сохраняет связи
+    {
+        TentacleTable table(4);
+        assert(table.GetSize() == 4);
+        assert(table.GetId(0) == 1 && table.GetId(3) == 4);
+        assert(!table.IsLinked(0));
+
+        const auto added = table.AddTentacle();
+        assert(added == 4 && table.GetId(added) == 5);
+
+        // Цепочка 0 -> 2 -> 4
+        table.LinkTo(0, 2);
+        table.LinkTo(2, 4);
+        assert(table.GetLinkedIndex(0) == 2);
+
+        vector<TentacleTable::Index> chain;
+        assert(table.FollowChain(0, [&chain](TentacleTable::Index index) {
+            chain.push_back(index);
+        }) == 2);
+        assert((chain == vector<TentacleTable::Index>{2, 4}));
+        assert(table.GetChainEnd(0) == 4);
+        assert(table.GetChainEnd(1) == 1);
+
+        assert((table.ResolveAllLinks() == vector<int>{3, 0, 5, 0, 0}));
+
+        TentacleTable copy(table);
+        table.Unlink(0);
+        assert(!table.IsLinked(0));
+        assert(copy.GetLinkedIndex(0) == 2);
+
+        // Цикл не приводит к бесконечному обходу
+        copy.LinkTo(4, 0);
+        assert(copy.FollowChain(0, [](TentacleTable::Index) {}) == copy.GetSize());
+    }
+
     // Копия осьминога имеет свою собственную копию щупалец, которые
     // копируют состояние щупалец оригинального осьминога
     {
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Таблица щупалец в виде структуры массивов (SoA).
+// Вместо объекта в куче на каждое щупальце и указателя linked_tentacle_
+// хранит идентификаторы и индексы прицепленных щупалец в параллельных векторах.
+// Ссылки задаются индексами, поэтому копия таблицы сразу сохраняет все связи,
+// а обход миллионов щупалец идёт по непрерывной памяти
+class TentacleTable {
+public:
+    using Index = std::uint32_t;
+
+    // Индекс, обозначающий отсутствие прицепленного щупальца
+    static constexpr Index kNoLink = std::numeric_limits<Index>::max();
+
+    TentacleTable() = default;
+
+    // Создаёт num_tentacles щупалец с идентификаторами 1, 2, 3, ...
+    explicit TentacleTable(size_t num_tentacles) {
+        Reserve(num_tentacles);
+        for (size_t i = 0; i < num_tentacles; ++i) {
+            AddTentacle();
+        }
+    }
+
+    void Reserve(size_t capacity) {
+        ids_.reserve(capacity);
+        links_.reserve(capacity);
+    }
+
+    // Добавляет новое щупальце с идентификатором, равным (количество_щупалец + 1).
+    // Возвращает индекс добавленного щупальца
+    Index AddTentacle() {
+        return AddTentacle(static_cast<int>(ids_.size()) + 1);
+    }
+
+    // Добавляет щупальце с заданным идентификатором, возвращает его индекс
+    Index AddTentacle(int id) {
+        assert(ids_.size() < kNoLink);
+
+        ids_.push_back(id);
+        links_.push_back(kNoLink);
+
+        return static_cast<Index>(ids_.size() - 1);
+    }
+
+    size_t GetSize() const noexcept {
+        return ids_.size();
+    }
+
+    int GetId(Index index) const noexcept {
+        assert(index < ids_.size());
+        return ids_[index];
+    }
+
+    // Возвращает индекс прицепленного щупальца либо kNoLink
+    Index GetLinkedIndex(Index index) const noexcept {
+        assert(index < links_.size());
+        return links_[index];
+    }
+
+    bool IsLinked(Index index) const noexcept {
+        return GetLinkedIndex(index) != kNoLink;
+    }
+
+    void LinkTo(Index index, Index target) noexcept {
+        assert(index < links_.size() && target < links_.size());
+        links_[index] = target;
+    }
+
+    void Unlink(Index index) noexcept {
+        assert(index < links_.size());
+        links_[index] = kNoLink;
+    }
+
+    // Проходит по цепочке ссылок, начиная со щупальца start (не включая его),
+    // и вызывает visitor(index) для каждого следующего щупальца.
+    // Обход останавливается на щупальце без ссылки либо после GetSize() шагов,
+    // поэтому циклы в графе не приводят к зацикливанию.
+    // Возвращает количество пройденных ссылок
+    template <typename Visitor>
+    size_t FollowChain(Index start, Visitor visitor) const {
+        size_t hops = 0;
+
+        for (Index current = GetLinkedIndex(start); current != kNoLink && hops < links_.size();
+             current = links_[current]) {
+            visitor(current);
+            ++hops;
+        }
+
+        return hops;
+    }
+
+    // Возвращает индекс последнего щупальца в цепочке ссылок, начинающейся в start.
+    // Для цикла возвращается щупальце, на котором остановился обход
+    Index GetChainEnd(Index start) const {
+        Index last = start;
+        FollowChain(start, [&last](Index index) {
+            last = index;
+        });
+        return last;
+    }
+
+    // Пакетно разрешает все ссылки за один линейный проход:
+    // linked_ids[i] получает идентификатор щупальца, к которому прицеплено i-е щупальце,
+    // либо no_link_id, если щупальце ни к чему не прицеплено.
+    // Вектор linked_ids переиспользуется между вызовами
+    void ResolveAllLinks(std::vector<int>& linked_ids, int no_link_id = 0) const {
+        linked_ids.resize(links_.size());
+
+        const Index* links = links_.data();
+        const int* ids = ids_.data();
+        int* out = linked_ids.data();
+
+        for (size_t i = 0, size = links_.size(); i < size; ++i) {
+            const Index link = links[i];
+            out[i] = link == kNoLink ? no_link_id : ids[link];
+        }
+    }
+
+    std::vector<int> ResolveAllLinks(int no_link_id = 0) const {
+        std::vector<int> linked_ids;
+        ResolveAllLinks(linked_ids, no_link_id);
+        return linked_ids;
+    }
+
+private:
+    // Параллельные массивы: i-е щупальце описывается ids_[i] и links_[i]
+    std::vector<int> ids_;
+    std::vector<Index> links_;
+};
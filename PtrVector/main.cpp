@@ -1,5 +1,6 @@
+#include <algorithm>
 #include <iostream>
-//#include <vector>
+#include <vector>
 
 #include "ptr_vector.h"
 
@@ -110,6 +111,90 @@ int main() {
         assert(item1_copy_count == 0);
         assert(other_item0_copy_count == 0);
     }
+
+    // Проверка параллельного копирования
+    {
+        // У каждого элемента свои счётчики, чтобы потоки не писали в общую память
+        vector<int> copy_counts(4 * PtrVector<CopyingSpy>::kMinElementsPerThread);
+        vector<int> deletion_counts(copy_counts.size());
+        {
+            PtrVector<CopyingSpy> v;
+            for (size_t i = 0; i < copy_counts.size(); ++i) {
+                v.GetItems().push_back(new CopyingSpy(copy_counts[i], deletion_counts[i]));
+            }
+            v.GetItems().push_back(nullptr);
+
+            PtrVector<CopyingSpy> v_copy(v, ParallelCopy(4));
+            assert(v_copy.GetItems().size() == v.GetItems().size());
+            assert(v_copy.GetItems().back() == nullptr);
+            for (size_t i = 0; i < copy_counts.size(); ++i) {
+                assert(v_copy.GetItems().at(i) != v.GetItems().at(i));
+            }
+            assert(all_of(copy_counts.begin(), copy_counts.end(), [](int count) {
+                return count == 1;
+            }));
+            assert(all_of(deletion_counts.begin(), deletion_counts.end(), [](int count) {
+                return count == 0;
+            }));
+        }
+        assert(all_of(deletion_counts.begin(), deletion_counts.end(), [](int count) {
+            return count == 2;
+        }));
+    }
+
+    // Проверка строгой гарантии безопасности исключений при параллельном копировании
+    // на нескольких потоках и на одном
+    for (size_t thread_count : {4, 1}) {
+        vector<int> copy_counts(4 * PtrVector<CopyingSpy>::kMinElementsPerThread);
+        vector<int> deletion_counts(copy_counts.size());
+
+        PtrVector<CopyingSpy> v;
+        for (size_t i = 0; i < copy_counts.size(); ++i) {
+            v.GetItems().push_back(new CopyingSpy(copy_counts[i], deletion_counts[i]));
+        }
+        v.GetItems().at(3 * PtrVector<CopyingSpy>::kMinElementsPerThread + 77)->ThrowOnCopy();
+
+        try {
+            PtrVector<CopyingSpy> v_copy(v, ParallelCopy(thread_count));
+            // Операция должна выбросить исключение
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+
+        // Все успешно созданные копии должны быть удалены
+        for (size_t i = 0; i < copy_counts.size(); ++i) {
+            assert(copy_counts[i] == deletion_counts[i]);
+        }
+    }
+
+    // Короткий вектор копируется на одном потоке с той же гарантией
+    {
+        int copy_counts[3] = {};
+        int deletion_counts[3] = {};
+
+        PtrVector<CopyingSpy> v;
+        for (size_t i = 0; i < 3; ++i) {
+            v.GetItems().push_back(new CopyingSpy(copy_counts[i], deletion_counts[i]));
+        }
+        v.GetItems().back()->ThrowOnCopy();
+
+        try {
+            PtrVector<CopyingSpy> v_copy(v, ParallelCopy(4));
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+
+        assert(copy_counts[0] == 1 && deletion_counts[0] == 1);
+        assert(copy_counts[1] == 1 && deletion_counts[1] == 1);
+        assert(copy_counts[2] == 0 && deletion_counts[2] == 0);
+    }
+
+    // Пустой вектор
+    {
+        PtrVector<CopyingSpy> v;
+        PtrVector<CopyingSpy> v_copy(v, ParallelCopy());
+        assert(v_copy.size() == 0);
+    }
 }
 
 /*
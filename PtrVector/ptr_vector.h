@@ -2,9 +2,23 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <thread>
 #include <vector>
 
+struct ParallelCopyProxyObject {
+    explicit ParallelCopyProxyObject(size_t threads): thread_count(threads) {}
+    size_t thread_count;
+};
+
+// Включает параллельное копирование элементов в конструкторе PtrVector.
+// При thread_count == 0 используется std::thread::hardware_concurrency()
+inline ParallelCopyProxyObject ParallelCopy(size_t thread_count = 0) {
+    return ParallelCopyProxyObject(thread_count);
+}
+
 template <typename T>
 class PtrVector {
 public:
@@ -24,6 +38,74 @@ public:
         }
     }
 
+    // Меньше элементов на поток не даём: запуск потока дороже их копирования
+    static constexpr size_t kMinElementsPerThread = 1024;
+
+    // Создаёт вектор указателей на копии объектов из other, копируя элементы
+    // на нескольких потоках. Если копирование хотя бы одного элемента выбросит
+    // исключение, все уже созданные копии удаляются, а исключение пробрасывается дальше.
+    // Небольшой вектор копируется на вызывающем потоке с той же гарантией
+    PtrVector(const PtrVector& other, const ParallelCopyProxyObject& parallel_copy) {
+        size_t thread_count = parallel_copy.thread_count;
+        if (thread_count == 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+        thread_count = std::max<size_t>(1, std::min(thread_count, other.size() / kMinElementsPerThread));
+
+        const auto& source = other.GetItems();
+        items_.assign(source.size(), nullptr);
+
+        std::vector<std::exception_ptr> errors(thread_count);
+        std::atomic<bool> failed = false;
+
+        auto copy_chunk = [&](size_t chunk, size_t from, size_t to) {
+            try {
+                for (size_t i = from; i < to && !failed.load(std::memory_order_relaxed); ++i) {
+                    if (source[i] != nullptr) {
+                        items_[i] = new T(*source[i]);
+                    }
+                }
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+                failed = true;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(thread_count - 1);
+
+        const size_t chunk_size = (source.size() + thread_count - 1) / thread_count;
+        try {
+            for (size_t chunk = 1; chunk < thread_count; ++chunk) {
+                const size_t from = std::min(chunk * chunk_size, source.size());
+                const size_t to = std::min(from + chunk_size, source.size());
+                workers.emplace_back(copy_chunk, chunk, from, to);
+            }
+        } catch (...) {
+            // Не удалось запустить поток: останавливаем уже запущенные
+            errors[0] = std::current_exception();
+            failed = true;
+        }
+
+        if (!failed) {
+            copy_chunk(0, 0, std::min(chunk_size, source.size()));
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (const auto& error : errors) {
+            if (error) {
+                for (auto item : items_) {
+                    delete item;
+                }
+                items_.clear();
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
     // Деструктор удаляет объекты в куче, на которые ссылаются указатели,
     // в векторе items_
     ~PtrVector() {
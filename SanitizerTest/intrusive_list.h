@@ -0,0 +1,224 @@
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+
+// Звено интрузивного списка. Тип элемента наследуется от него, поэтому звено хранится
+// внутри самого объекта. Разные Tag позволяют одному объекту состоять в нескольких списках
+template <typename Tag = void>
+struct IntrusiveListHook {
+    IntrusiveListHook* next_hook = nullptr;
+};
+
+// Односвязный список объектов, которые хранятся в памяти пользователя.
+// Список не владеет элементами и не выделяет память: вставка и удаление только
+// переписывают указатели в звеньях. Интерфейс повторяет SingleLinkedList.
+// Объект должен быть удалён из списка до своего разрушения
+template <typename Type, typename Tag = void>
+class IntrusiveSingleLinkedList {
+    using Hook = IntrusiveListHook<Tag>;
+
+public:
+    template <typename ValueType>
+    class BasicIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+
+    public:
+        friend class IntrusiveSingleLinkedList;
+
+        BasicIterator() = default;
+
+        BasicIterator(const BasicIterator<Type>& other) noexcept {
+            hook_ = other.hook_;
+        }
+
+        explicit BasicIterator(Hook* hook): hook_(hook) {}
+
+        BasicIterator& operator=(const BasicIterator& right) = default;
+
+    public:
+        [[nodiscard]] bool operator==(const BasicIterator<const Type>& right) const noexcept {
+            return hook_ == right.hook_;
+        }
+
+        [[nodiscard]] bool operator==(const BasicIterator<Type>& right) const noexcept {
+            return hook_ == right.hook_;
+        }
+
+        [[nodiscard]] bool operator!=(const BasicIterator<const Type>& right) const noexcept {
+            return !(*this == right);
+        }
+
+        [[nodiscard]] bool operator!=(const BasicIterator<Type>& right) const noexcept {
+            return !(*this == right);
+        }
+
+        BasicIterator& operator++() noexcept {
+            hook_ = hook_->next_hook;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            auto old_value(*this);
+            ++(*this);
+            return old_value;
+        }
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return *static_cast<Type*>(hook_);
+        }
+
+        [[nodiscard]] pointer operator->() const noexcept {
+            return static_cast<Type*>(hook_);
+        }
+
+    private:
+        Hook* hook_ = nullptr;
+    };
+
+    using value_type = Type;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using Iterator = BasicIterator<Type>;
+    using ConstIterator = BasicIterator<const Type>;
+
+public:
+    IntrusiveSingleLinkedList() = default;
+
+    IntrusiveSingleLinkedList(const IntrusiveSingleLinkedList&) = delete;
+    IntrusiveSingleLinkedList& operator=(const IntrusiveSingleLinkedList&) = delete;
+
+    IntrusiveSingleLinkedList(IntrusiveSingleLinkedList&& other) noexcept {
+        swap(other);
+    }
+
+    IntrusiveSingleLinkedList& operator=(IntrusiveSingleLinkedList&& right) noexcept {
+        if (this != &right) {
+            Clear();
+            swap(right);
+        }
+
+        return *this;
+    }
+
+    ~IntrusiveSingleLinkedList() {
+        Clear();
+    }
+
+public:
+    [[nodiscard]] size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    void PushFront(Type& value) noexcept {
+        InsertAfter(cbefore_begin(), value);
+    }
+
+    void PopFront() noexcept {
+        EraseAfter(cbefore_begin());
+    }
+
+    // Отцепляет все элементы, сами объекты не затрагиваются
+    void Clear() noexcept {
+        while (head_.next_hook) {
+            Hook* current_hook = head_.next_hook;
+            head_.next_hook = current_hook->next_hook;
+            current_hook->next_hook = nullptr;
+        }
+        size_ = 0;
+    }
+
+    void swap(IntrusiveSingleLinkedList& other) noexcept {
+        std::swap(head_.next_hook, other.head_.next_hook);
+        std::swap(size_, other.size_);
+    }
+
+    // value не должен состоять в другом списке с тем же Tag
+    Iterator InsertAfter(ConstIterator before_inserted, Type& value) noexcept {
+        Hook* hook = before_inserted.hook_;
+        assert(hook != nullptr);
+
+        Hook* inserted = &value;
+        inserted->next_hook = hook->next_hook;
+        hook->next_hook = inserted;
+
+        ++size_;
+
+        return Iterator{inserted};
+    }
+
+    // Отцепляет элемент, следующий за before_deleted, и возвращает итератор на элемент после него
+    Iterator EraseAfter(ConstIterator before_deleted) noexcept {
+        Hook* hook = before_deleted.hook_;
+
+        if (hook == nullptr || hook->next_hook == nullptr) {
+            return Iterator{};
+        }
+
+        Hook* erased = hook->next_hook;
+        hook->next_hook = erased->next_hook;
+        erased->next_hook = nullptr;
+
+        --size_;
+
+        return Iterator{hook->next_hook};
+    }
+
+public:
+    [[nodiscard]] Iterator begin() noexcept {
+        return Iterator{head_.next_hook};
+    }
+
+    [[nodiscard]] Iterator end() noexcept {
+        return Iterator{nullptr};
+    }
+
+    [[nodiscard]] ConstIterator begin() const noexcept {
+        return ConstIterator{head_.next_hook};
+    }
+
+    [[nodiscard]] ConstIterator end() const noexcept {
+        return ConstIterator{nullptr};
+    }
+
+    [[nodiscard]] ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    [[nodiscard]] ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] Iterator before_begin() noexcept {
+        return Iterator{&head_};
+    }
+
+    [[nodiscard]] ConstIterator cbefore_begin() const noexcept {
+        return ConstIterator{const_cast<Hook*>(&head_)};
+    }
+
+    [[nodiscard]] ConstIterator before_begin() const noexcept {
+        return cbefore_begin();
+    }
+
+private:
+    // Звено-заголовок не принадлежит ни одному объекту Type и не разыменовывается
+    Hook head_{};
+    size_t size_ = 0;
+};
+
+template <typename Type, typename Tag>
+void swap(IntrusiveSingleLinkedList<Type, Tag>& left, IntrusiveSingleLinkedList<Type, Tag>& right) noexcept {
+    left.swap(right);
+}
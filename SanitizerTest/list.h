@@ -4,6 +4,16 @@
 #include <cstddef>
 #include <algorithm>
 #include <cassert>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "node_pool.h"
+
+// На сколько узлов вперёд PrefetchingConstIterator загружает список в кэш
+inline constexpr size_t kListPrefetchDistance = 4;
 
 template <typename Type>
 class SingleLinkedList {
@@ -16,6 +26,18 @@ public:
         , next_node(next) {
         }
         
+        Node(Type&& node_value, Node* next)
+        : value(std::move(node_value))
+        , next_node(next) {
+        }
+        
+        // Конструирует значение узла на месте из аргументов args
+        template <typename... Args>
+        Node(Node* next, std::in_place_t, Args&&... args)
+        : value(std::forward<Args>(args)...)
+        , next_node(next) {
+        }
+        
         Type value;
         Node* next_node = nullptr;
     };
@@ -92,10 +114,84 @@ public:
     using const_reference = const value_type&;
     using Iterator = BasicIterator<Type>;
     using ConstIterator = BasicIterator<const Type>;
+    using Pool = NodePool<Node>;
+    
+    // Константный итератор, который при каждом шаге подгружает в кэш узел,
+    // находящийся на kDistance шагов впереди. Полезен для полного обхода списка,
+    // узлы которого разбросаны по памяти
+    template <size_t kDistance>
+    class PrefetchingConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+        
+    public:
+        PrefetchingConstIterator() = default;
+        
+        explicit PrefetchingConstIterator(Node* node) noexcept
+        : node_(node)
+        , ahead_(node) {
+            for (size_t i = 0; i < kDistance && ahead_ != nullptr; ++i) {
+                ahead_ = ahead_->next_node;
+                Prefetch(ahead_);
+            }
+        }
+        
+    public:
+        [[nodiscard]] bool operator==(const PrefetchingConstIterator& right) const noexcept {
+            return node_ == right.node_;
+        }
+        
+        [[nodiscard]] bool operator!=(const PrefetchingConstIterator& right) const noexcept {
+            return !(*this == right);
+        }
+        
+        PrefetchingConstIterator& operator++() noexcept {
+            node_ = node_->next_node;
+            if (ahead_ != nullptr) {
+                ahead_ = ahead_->next_node;
+                Prefetch(ahead_);
+            }
+            return *this;
+        }
+        
+        PrefetchingConstIterator operator++(int) noexcept {
+            auto old_value(*this);
+            ++(*this);
+            return old_value;
+        }
+        
+        [[nodiscard]] reference operator*() const noexcept {
+            return node_->value;
+        }
+        
+        [[nodiscard]] pointer operator->() const noexcept {
+            return &(node_->value);
+        }
+        
+    private:
+        static void Prefetch([[maybe_unused]] const Node* node) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(node);
+#endif
+        }
+        
+    private:
+        Node* node_ = nullptr;
+        Node* ahead_ = nullptr;
+    };
     
 public:
     SingleLinkedList() = default;
     
+    // Создаёт пустой список, берущий узлы из разделяемого пула
+    explicit SingleLinkedList(std::shared_ptr<Pool> pool) noexcept
+    : pool_(std::move(pool)) {
+    }
+    
     SingleLinkedList(std::initializer_list<Type> values) {
         Assign(values.begin(), values.end());
     }
@@ -104,13 +200,29 @@ public:
         Assign(other.begin(), other.end());
     }
     
+    SingleLinkedList(SingleLinkedList&& other) noexcept {
+        swap(other);
+    }
+    
     ~SingleLinkedList() {
         Clear();
     }
     
+    // Переиспользует уже выделенные узлы: значения перезаписываются,
+    // выделяются или освобождаются только недостающие или лишние узлы.
+    // При исключении список остаётся корректным, но может содержать часть новых значений
     SingleLinkedList& operator=(const SingleLinkedList& right) {
         if (this != &right) {
-            Assign(right.begin(), right.end());
+            AssignReusingNodes(right.begin(), right.end());
+        }
+        
+        return *this;
+    }
+    
+    SingleLinkedList& operator=(SingleLinkedList&& right) noexcept {
+        if (this != &right) {
+            SingleLinkedList temp(std::move(right));
+            swap(temp);
         }
         
         return *this;
@@ -126,15 +238,24 @@ public:
     }
     
     void PushFront(const Type& value)  {
-        head_.next_node = new Node(value, head_.next_node);
-        ++size_;
+        EmplaceFront(value);
+    }
+    
+    void PushFront(Type&& value)  {
+        EmplaceFront(std::move(value));
+    }
+    
+    // Конструирует новый первый элемент из args, возвращает ссылку на него
+    template <typename... Args>
+    reference EmplaceFront(Args&&... args) {
+        return *EmplaceAfter(cbefore_begin(), std::forward<Args>(args)...);
     }
     
     void Clear() noexcept  {
         while (head_.next_node) {
             Node* current_node = head_.next_node;
             head_.next_node = current_node->next_node;
-            delete current_node;
+            DestroyNode(current_node);
             
             --size_;
         }
@@ -143,14 +264,34 @@ public:
     void swap(SingleLinkedList& other) noexcept  {
         std::swap(head_.next_node, other.head_.next_node);
         std::swap(size_, other.size_);
+        std::swap(pool_, other.pool_);
+    }
+    
+    // Возвращает пул узлов списка, создавая его при первом обращении.
+    // Пул можно передать в конструктор другого списка, чтобы они делили узлы
+    [[nodiscard]] const std::shared_ptr<Pool>& GetPool() {
+        if (!pool_) {
+            pool_ = std::make_shared<Pool>();
+        }
+        return pool_;
     }
     
     Iterator InsertAfter(ConstIterator before_inserted, const Type& value)  {
+        return EmplaceAfter(before_inserted, value);
+    }
+    
+    Iterator InsertAfter(ConstIterator before_inserted, Type&& value)  {
+        return EmplaceAfter(before_inserted, std::move(value));
+    }
+    
+    // Конструирует элемент из args на месте после before_inserted
+    template <typename... Args>
+    Iterator EmplaceAfter(ConstIterator before_inserted, Args&&... args)  {
         auto node = before_inserted.GetRawPointer();
         
         assert(node != nullptr);
         
-        node->next_node = new Node{value, node->next_node};
+        node->next_node = CreateNode(node->next_node, std::in_place, std::forward<Args>(args)...);
         
         ++size_;
         
@@ -164,7 +305,7 @@ public:
         
         auto node_to_delete = head_.next_node;
         head_.next_node = head_.next_node->next_node;
-        delete node_to_delete;
+        DestroyNode(node_to_delete);
         
         --size_;
     }
@@ -184,13 +325,122 @@ public:
         
         node->next_node = node->next_node->next_node;
         
-        delete node_to_delete;
+        DestroyNode(node_to_delete);
         
         --size_;
         
         return Iterator{node->next_node};
     }
     
+    // Операции SpliceAfter, Merge, Sort, Reverse и Unique только перевязывают узлы
+    // и не выделяют память под элементы. Узлы переносятся между списками без копирования
+    // и при разных пулах: пулы списков объединяются, см. NodePool::Join, и дальше
+    // списки делят один пул, как если бы второй был создан с пулом первого
+    
+    // Переносит все элементы other после pos
+    void SpliceAfter(ConstIterator pos, SingleLinkedList& other) {
+        SpliceAfter(pos, other, other.cbefore_begin(), other.cend());
+    }
+    
+    // Переносит элемент, следующий за before_node в other, после pos
+    void SpliceAfter(ConstIterator pos, SingleLinkedList& other, ConstIterator before_node) {
+        Node* node = before_node.node_->next_node;
+        if (node == nullptr || pos.node_ == before_node.node_ || pos.node_ == node) {
+            return;
+        }
+        
+        SpliceAfter(pos, other, before_node, ConstIterator{node->next_node});
+    }
+    
+    // Переносит элементы из интервала (before_first, last) списка other после pos.
+    // pos не должен лежать внутри переносимого интервала
+    void SpliceAfter(ConstIterator pos, SingleLinkedList& other, ConstIterator before_first, ConstIterator last) {
+        Node* first = before_first.node_->next_node;
+        if (first == last.node_) {
+            return;
+        }
+        
+        AdoptNodesOf(other);
+        
+        Node* tail = first;
+        size_t count = 1;
+        while (tail->next_node != last.node_) {
+            tail = tail->next_node;
+            ++count;
+        }
+        
+        before_first.node_->next_node = last.node_;
+        tail->next_node = pos.node_->next_node;
+        pos.node_->next_node = first;
+        
+        other.size_ -= count;
+        size_ += count;
+    }
+    
+    // Сливает отсортированный список other в этот отсортированный список.
+    // Слияние устойчиво, other становится пустым
+    template <typename Compare = std::less<>>
+    void Merge(SingleLinkedList& other, Compare comp = Compare{}) {
+        if (&other == this || other.IsEmpty()) {
+            return;
+        }
+        
+        AdoptNodesOf(other);
+        
+        MergeNodes(head_.next_node, other.head_.next_node, &head_, comp);
+        size_ += other.size_;
+        other.head_.next_node = nullptr;
+        other.size_ = 0;
+    }
+    
+    // Устойчивая сортировка слиянием снизу вверх, O(n log n) времени и O(1) дополнительной памяти
+    template <typename Compare = std::less<>>
+    void Sort(Compare comp = Compare{}) {
+        for (size_t width = 1; width < size_; width *= 2) {
+            Node* tail = &head_;
+            Node* current = head_.next_node;
+            
+            while (current != nullptr) {
+                Node* left = current;
+                Node* right = CutAfter(left, width);
+                current = CutAfter(right, width);
+                tail = MergeNodes(left, right, tail, comp);
+            }
+        }
+    }
+    
+    void Reverse() noexcept {
+        Node* reversed = nullptr;
+        Node* current = head_.next_node;
+        
+        while (current != nullptr) {
+            Node* next = current->next_node;
+            current->next_node = reversed;
+            reversed = current;
+            current = next;
+        }
+        
+        head_.next_node = reversed;
+    }
+    
+    // Удаляет идущие подряд элементы, для которых pred(предыдущий, текущий) == true.
+    // Возвращает количество удалённых элементов
+    template <typename BinaryPredicate = std::equal_to<>>
+    size_t Unique(BinaryPredicate pred = BinaryPredicate{}) {
+        const size_t old_size = size_;
+        Node* current = head_.next_node;
+        
+        while (current != nullptr && current->next_node != nullptr) {
+            if (pred(current->value, current->next_node->value)) {
+                EraseAfter(ConstIterator{current});
+            } else {
+                current = current->next_node;
+            }
+        }
+        
+        return old_size - size_;
+    }
+    
 public:
     [[nodiscard]] Iterator begin() noexcept  {
         return Iterator{head_.next_node};
@@ -228,10 +478,22 @@ public:
         return ConstIterator{const_cast<Node *>(&head_)};
     }
     
+    template <size_t kDistance = kListPrefetchDistance>
+    [[nodiscard]] PrefetchingConstIterator<kDistance> PrefetchingBegin() const noexcept {
+        return PrefetchingConstIterator<kDistance>{head_.next_node};
+    }
+    
+    template <size_t kDistance = kListPrefetchDistance>
+    [[nodiscard]] PrefetchingConstIterator<kDistance> PrefetchingEnd() const noexcept {
+        return PrefetchingConstIterator<kDistance>{};
+    }
+    
 private:
     template <typename InputIterator>
     void Assign(InputIterator from, InputIterator to) {
-        SingleLinkedList temp;
+        SingleLinkedList temp(GetPool());
+        
+        ReserveNodes(from, to);
         
         auto last_node = temp.before_begin();
         
@@ -243,9 +505,112 @@ private:
         swap(temp);
     }
     
+    template <typename InputIterator>
+    void AssignReusingNodes(InputIterator from, InputIterator to) {
+        Node* last_node = &head_;
+        auto it = from;
+        
+        for (; it != to && last_node->next_node != nullptr; ++it) {
+            last_node->next_node->value = *it;
+            last_node = last_node->next_node;
+        }
+        
+        while (last_node->next_node != nullptr) {
+            EraseAfter(ConstIterator{last_node});
+        }
+        
+        ReserveNodes(it, to);
+        
+        for (auto pos = ConstIterator{last_node}; it != to; ++it) {
+            pos = InsertAfter(pos, *it);
+        }
+    }
+    
+    // Для прямых итераторов заранее выделяет память под все узлы одним блоком,
+    // чтобы новые узлы лежали в памяти подряд
+    template <typename InputIterator>
+    void ReserveNodes(InputIterator from, InputIterator to) {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            GetPool()->Reserve(static_cast<size_t>(std::distance(from, to)));
+        }
+    }
+    
+    // Готовит пул этого списка к приёму узлов непустого списка other.
+    // Список без пула просто начинает делить пул other
+    void AdoptNodesOf(SingleLinkedList& other) {
+        if (pool_ == other.pool_) {
+            return;
+        }
+        
+        if (!pool_) {
+            pool_ = other.pool_;
+            return;
+        }
+        
+        pool_ = Pool::Join(pool_, other.pool_);
+        other.pool_ = pool_;
+    }
+    
+    // Отрезает цепочку после count узлов, начиная с node, возвращает начало оставшейся части
+    static Node* CutAfter(Node* node, size_t count) noexcept {
+        for (size_t i = 1; node != nullptr && i < count; ++i) {
+            node = node->next_node;
+        }
+        
+        if (node == nullptr) {
+            return nullptr;
+        }
+        
+        Node* rest = node->next_node;
+        node->next_node = nullptr;
+        return rest;
+    }
+    
+    // Сливает отсортированные цепочки left и right и подвешивает результат к tail.
+    // Возвращает последний узел результата
+    template <typename Compare>
+    static Node* MergeNodes(Node* left, Node* right, Node* tail, Compare& comp) {
+        while (left != nullptr && right != nullptr) {
+            if (comp(right->value, left->value)) {
+                tail->next_node = right;
+                right = right->next_node;
+            } else {
+                tail->next_node = left;
+                left = left->next_node;
+            }
+            tail = tail->next_node;
+        }
+        
+        tail->next_node = left != nullptr ? left : right;
+        while (tail->next_node != nullptr) {
+            tail = tail->next_node;
+        }
+        
+        return tail;
+    }
+    
+    template <typename... Args>
+    Node* CreateNode(Args&&... args) {
+        Pool& pool = *GetPool();
+        void* memory = pool.Allocate();
+        try {
+            return new (memory) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            pool.Deallocate(memory);
+            throw;
+        }
+    }
+    
+    void DestroyNode(Node* node) noexcept {
+        node->~Node();
+        pool_->Deallocate(node);
+    }
+    
 private:
     Node head_{};
     size_t size_ = 0;
+    std::shared_ptr<Pool> pool_;
 };
 
 // swap
@@ -291,3 +656,24 @@ template <typename Type>
 bool operator>=(const SingleLinkedList<Type>& left, const SingleLinkedList<Type>& right) {
     return right <= left;
 }
+
+// Варианты operator== и operator< с предвыборкой узлов обоих списков
+template <size_t kDistance = kListPrefetchDistance, typename Type>
+bool PrefetchingEqual(const SingleLinkedList<Type>& left, const SingleLinkedList<Type>& right) {
+    if (&left == &right) {
+        return true;
+    }
+    
+    if (left.GetSize() != right.GetSize()) {
+        return false;
+    }
+    
+    return std::equal(left.template PrefetchingBegin<kDistance>(), left.template PrefetchingEnd<kDistance>(),
+                      right.template PrefetchingBegin<kDistance>());
+}
+
+template <size_t kDistance = kListPrefetchDistance, typename Type>
+bool PrefetchingLess(const SingleLinkedList<Type>& left, const SingleLinkedList<Type>& right) {
+    return std::lexicographical_compare(left.template PrefetchingBegin<kDistance>(), left.template PrefetchingEnd<kDistance>(),
+                                        right.template PrefetchingBegin<kDistance>(), right.template PrefetchingEnd<kDistance>());
+}
@@ -1,10 +1,22 @@
 #include <deque>
 #include <iostream>
 
+#include "tests.h"
+
 using namespace std;
 
 
 int main() {
+    TestListBasics();
+    TestListNodePool();
+    TestUnrolledList();
+    TestListMoveAndEmplace();
+    TestListSpliceAndSort();
+    TestListAssignmentReusesNodes();
+    TestIntrusiveList();
+    TestSkipList();
+    TestListPrefetchingIteration();
+    
     deque<int> numbers = {1};
     auto it = numbers.begin();
     cout << *it << endl;
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Пул памяти под узлы фиксированного размера.
+// Память выделяется блоками, узлы внутри блока выдаются подряд, поэтому
+// последовательно созданные узлы лежат рядом. Освобождённые узлы попадают
+// в список свободных и переиспользуются без обращения к malloc/free.
+// Пулы можно объединить, чтобы списки с разными пулами обменивались узлами
+// без копирования, см. Join.
+// Пул не потокобезопасен: разделять его можно между списками одного потока
+template <typename Node>
+class NodePool {
+public:
+    static constexpr size_t kInitialBlockSize = 16;
+    static constexpr size_t kMaxBlockSize = 4096;
+
+    NodePool() = default;
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // К моменту разрушения пула все узлы должны быть уничтожены
+    ~NodePool() = default;
+
+    // Возвращает неинициализированную память под один узел
+    [[nodiscard]] void* Allocate() {
+        if (parent_) {
+            return GetRoot().Allocate();
+        }
+
+        if (free_list_ != nullptr) {
+            Slot* slot = free_list_;
+            free_list_ = slot->next;
+            return slot;
+        }
+
+        if (block_pos_ == block_end_) {
+            AllocateBlock();
+        }
+        return block_pos_++;
+    }
+
+    // Возвращает память узла в пул. Деструктор узла должен быть уже вызван
+    void Deallocate(void* node) noexcept {
+        if (parent_) {
+            GetRoot().Deallocate(node);
+            return;
+        }
+
+        auto slot = static_cast<Slot*>(node);
+        slot->next = free_list_;
+        free_list_ = slot;
+    }
+
+    // Объединяет пулы left и right: дальше они выдают узлы из общих блоков и общего
+    // списка свободных, а узел, выданный одним, можно вернуть в другой.
+    // Блоки меньшего пула переходят к большему, меньший лишь переадресует ему вызовы,
+    // поэтому память, освобождённую одним списком, переиспользуют все.
+    // Объединение необратимо и стоит O(блоков и свободных узлов меньшего пула).
+    // Возвращает пул, владеющий общими блоками
+    static std::shared_ptr<NodePool> Join(std::shared_ptr<NodePool> left, std::shared_ptr<NodePool> right) {
+        left = FindRoot(std::move(left));
+        right = FindRoot(std::move(right));
+        if (left != right) {
+            if (left->capacity_ < right->capacity_) {
+                std::swap(left, right);
+            }
+            left->Absorb(*right);
+            right->parent_ = left;
+        }
+        return left;
+    }
+
+    // Количество узлов, под которые пул уже выделил память
+    size_t GetCapacity() const noexcept {
+        return parent_ ? GetRoot().capacity_ : capacity_;
+    }
+
+    // Заранее выделяет память так, чтобы следующие count узлов были выданы без новых блоков
+    void Reserve(size_t count) {
+        if (parent_) {
+            GetRoot().Reserve(count);
+            return;
+        }
+
+        size_t available = static_cast<size_t>(block_end_ - block_pos_);
+        for (Slot* slot = free_list_; slot != nullptr && available < count; slot = slot->next) {
+            ++available;
+        }
+        if (available < count) {
+            next_block_size_ = std::max(next_block_size_, count - available);
+            AllocateBlock();
+        }
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    static std::shared_ptr<NodePool> FindRoot(std::shared_ptr<NodePool> pool) {
+        while (pool->parent_) {
+            pool = pool->parent_;
+        }
+        return pool;
+    }
+
+    NodePool& GetRoot() const noexcept {
+        NodePool* root = parent_.get();
+        while (root->parent_) {
+            root = root->parent_.get();
+        }
+        return *root;
+    }
+
+    // Забирает блоки other, его свободные узлы и остаток текущего блока
+    void Absorb(NodePool& other) {
+        blocks_.reserve(blocks_.size() + other.blocks_.size());
+        while (other.block_pos_ != other.block_end_) {
+            Deallocate(other.block_pos_++);
+        }
+        while (other.free_list_ != nullptr) {
+            Slot* slot = other.free_list_;
+            other.free_list_ = slot->next;
+            Deallocate(slot);
+        }
+
+        std::move(other.blocks_.begin(), other.blocks_.end(), std::back_inserter(blocks_));
+        other.blocks_.clear();
+        capacity_ += std::exchange(other.capacity_, 0);
+        next_block_size_ = std::max(next_block_size_, other.next_block_size_);
+    }
+
+    void AllocateBlock() {
+        // Остаток текущего блока отправляем в список свободных, чтобы не потерять его
+        while (block_pos_ != block_end_) {
+            Deallocate(block_pos_++);
+        }
+
+        blocks_.push_back(std::make_unique<Slot[]>(next_block_size_));
+        block_pos_ = blocks_.back().get();
+        block_end_ = block_pos_ + next_block_size_;
+        capacity_ += next_block_size_;
+
+        next_block_size_ = std::min(next_block_size_ * 2, std::max(kMaxBlockSize, next_block_size_));
+    }
+
+private:
+    std::vector<std::unique_ptr<Slot[]>> blocks_;
+    // Пул, к которому присоединён этот, см. Join. Пока он задан, собственных блоков нет
+    std::shared_ptr<NodePool> parent_;
+    Slot* free_list_ = nullptr;
+    Slot* block_pos_ = nullptr;
+    Slot* block_end_ = nullptr;
+    size_t next_block_size_ = kInitialBlockSize;
+    size_t capacity_ = 0;
+};
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <random>
+#include <tuple>
+#include <utility>
+
+#include "node_pool.h"
+
+// Упорядоченное множество на основе списка с пропусками.
+// Find, Insert и Erase работают за O(log n) в среднем, итерация идёт по нижнему
+// уровню в порядке возрастания, как по SingleLinkedList.
+// Узел хранит значение и башню из height указателей на следующие узлы;
+// башни одной высоты выделяются из общего пула
+template <typename Type, typename Compare = std::less<Type>>
+class SkipList {
+public:
+    static constexpr size_t kMaxLevel = 16;
+
+    struct Node {
+        template <typename... Args>
+        explicit Node(size_t tower_height, Args&&... args)
+        : value(std::forward<Args>(args)...)
+        , height(tower_height) {
+        }
+
+        // Башня указателей лежит в памяти сразу за узлом
+        Node** Next() const noexcept;
+
+        Type value;
+        size_t height = 0;
+    };
+
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+    public:
+        friend class SkipList;
+
+        ConstIterator() = default;
+
+        explicit ConstIterator(Node* node): node_(node) {}
+
+    public:
+        [[nodiscard]] bool operator==(const ConstIterator& right) const noexcept {
+            return node_ == right.node_;
+        }
+
+        [[nodiscard]] bool operator!=(const ConstIterator& right) const noexcept {
+            return !(*this == right);
+        }
+
+        ConstIterator& operator++() noexcept {
+            node_ = node_->Next()[0];
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            auto old_value(*this);
+            ++(*this);
+            return old_value;
+        }
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return node_->value;
+        }
+
+        [[nodiscard]] pointer operator->() const noexcept {
+            return &(node_->value);
+        }
+
+    private:
+        Node* node_ = nullptr;
+    };
+
+    using value_type = Type;
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+    // Элементы упорядочены, поэтому изменять их через итератор нельзя
+    using Iterator = ConstIterator;
+
+public:
+    SkipList() = default;
+
+    explicit SkipList(Compare comp)
+    : comp_(std::move(comp)) {
+    }
+
+    SkipList(std::initializer_list<Type> values) {
+        for (const Type& value : values) {
+            Insert(value);
+        }
+    }
+
+    // Исходный список уже упорядочен, поэтому узлы добавляются в конец за O(n)
+    SkipList(const SkipList& other)
+    : comp_(other.comp_) {
+        std::array<Node**, kMaxLevel> tails;
+        for (size_t level = 0; level < kMaxLevel; ++level) {
+            tails[level] = &head_next_[level];
+        }
+
+        try {
+            for (const Type& value : other) {
+                const size_t height = RandomHeight();
+                Node* node = CreateNode(height, value);
+                for (size_t level = 0; level < height; ++level) {
+                    *tails[level] = node;
+                    tails[level] = &node->Next()[level];
+                }
+                level_ = std::max(level_, height);
+                ++size_;
+            }
+        } catch (...) {
+            Clear();
+            throw;
+        }
+    }
+
+    SkipList(SkipList&& other) noexcept {
+        swap(other);
+    }
+
+    ~SkipList() {
+        Clear();
+    }
+
+    SkipList& operator=(const SkipList& right) {
+        if (this != &right) {
+            SkipList temp(right);
+            swap(temp);
+        }
+
+        return *this;
+    }
+
+    SkipList& operator=(SkipList&& right) noexcept {
+        if (this != &right) {
+            SkipList temp(std::move(right));
+            swap(temp);
+        }
+
+        return *this;
+    }
+
+public:
+    [[nodiscard]] size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    void Clear() noexcept {
+        Node* current_node = head_next_[0];
+        while (current_node) {
+            Node* next_node = current_node->Next()[0];
+            DestroyNode(current_node);
+            current_node = next_node;
+        }
+
+        head_next_.fill(nullptr);
+        level_ = 1;
+        size_ = 0;
+    }
+
+    void swap(SkipList& other) noexcept {
+        using std::swap;
+        swap(head_next_, other.head_next_);
+        swap(level_, other.level_);
+        swap(size_, other.size_);
+        swap(pools_, other.pools_);
+        swap(comp_, other.comp_);
+        swap(random_, other.random_);
+    }
+
+    // Возвращает итератор на первый элемент, не меньший value
+    [[nodiscard]] ConstIterator LowerBound(const Type& value) const {
+        Node* const* next = head_next_.data();
+        for (size_t level = level_; level-- > 0;) {
+            while (next[level] != nullptr && comp_(next[level]->value, value)) {
+                next = next[level]->Next();
+            }
+        }
+        return ConstIterator{next[0]};
+    }
+
+    // Возвращает итератор на элемент, равный value, либо end()
+    [[nodiscard]] ConstIterator Find(const Type& value) const {
+        auto it = LowerBound(value);
+        if (it != end() && !comp_(value, *it)) {
+            return it;
+        }
+        return end();
+    }
+
+    [[nodiscard]] bool Contains(const Type& value) const {
+        return Find(value) != end();
+    }
+
+    // Вставляет value, если равного элемента ещё нет.
+    // Возвращает итератор на элемент и признак того, что вставка произошла
+    std::pair<ConstIterator, bool> Insert(const Type& value) {
+        return DoInsert(value);
+    }
+
+    std::pair<ConstIterator, bool> Insert(Type&& value) {
+        return DoInsert(std::move(value));
+    }
+
+    // Удаляет элемент, равный value. Возвращает количество удалённых элементов
+    size_t Erase(const Type& value) {
+        std::array<Node**, kMaxLevel> update;
+        FindPredecessors(value, update);
+
+        Node* node = *update[0];
+        if (node == nullptr || comp_(value, node->value)) {
+            return 0;
+        }
+
+        for (size_t level = 0; level < node->height; ++level) {
+            assert(*update[level] == node);
+            *update[level] = node->Next()[level];
+        }
+        DestroyNode(node);
+        --size_;
+
+        while (level_ > 1 && head_next_[level_ - 1] == nullptr) {
+            --level_;
+        }
+
+        return 1;
+    }
+
+public:
+    [[nodiscard]] ConstIterator begin() const noexcept {
+        return ConstIterator{head_next_[0]};
+    }
+
+    [[nodiscard]] ConstIterator end() const noexcept {
+        return ConstIterator{nullptr};
+    }
+
+    [[nodiscard]] ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    [[nodiscard]] ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Смещение башни указателей относительно начала узла
+    static constexpr size_t kTowerOffset = (sizeof(Node) + alignof(Node*) - 1) / alignof(Node*) * alignof(Node*);
+
+    // Память под узел с башней высоты kHeight
+    template <size_t kHeight>
+    struct alignas(std::max(alignof(Node), alignof(Node*))) TowerStorage {
+        unsigned char bytes[kTowerOffset + kHeight * sizeof(Node*)];
+    };
+
+    template <size_t... kLevels>
+    static auto MakePools(std::index_sequence<kLevels...>) -> std::tuple<NodePool<TowerStorage<kLevels + 1>>...>;
+
+    // Отдельный пул для каждой высоты башни
+    using Pools = decltype(MakePools(std::make_index_sequence<kMaxLevel>{}));
+
+    // Высота башни распределена геометрически с вероятностью 1/4 перехода на следующий уровень
+    size_t RandomHeight() {
+        size_t height = 1;
+        auto bits = random_();
+        while (height < kMaxLevel && (bits & 3) == 0) {
+            ++height;
+            bits >>= 2;
+        }
+        return height;
+    }
+
+    // Для каждого уровня находит ячейку башни, указывающую на первый узел, не меньший value
+    void FindPredecessors(const Type& value, std::array<Node**, kMaxLevel>& update) {
+        Node** next = head_next_.data();
+        for (size_t level = level_; level-- > 0;) {
+            while (next[level] != nullptr && comp_(next[level]->value, value)) {
+                next = next[level]->Next();
+            }
+            update[level] = &next[level];
+        }
+    }
+
+    template <typename ValueType>
+    std::pair<ConstIterator, bool> DoInsert(ValueType&& value) {
+        std::array<Node**, kMaxLevel> update;
+        FindPredecessors(value, update);
+
+        Node* found = *update[0];
+        if (found != nullptr && !comp_(value, found->value)) {
+            return {ConstIterator{found}, false};
+        }
+
+        const size_t height = RandomHeight();
+        Node* node = CreateNode(height, std::forward<ValueType>(value));
+
+        for (size_t level = level_; level < height; ++level) {
+            update[level] = &head_next_[level];
+        }
+        level_ = std::max(level_, height);
+
+        for (size_t level = 0; level < height; ++level) {
+            node->Next()[level] = *update[level];
+            *update[level] = node;
+        }
+        ++size_;
+
+        return {ConstIterator{node}, true};
+    }
+
+    template <size_t... kLevels>
+    void* AllocateTower(size_t height, std::index_sequence<kLevels...>) {
+        void* memory = nullptr;
+        ((height == kLevels + 1 && (memory = std::get<kLevels>(*pools_).Allocate(), true)) || ...);
+        return memory;
+    }
+
+    template <size_t... kLevels>
+    void DeallocateTower(void* memory, size_t height, std::index_sequence<kLevels...>) noexcept {
+        ((height == kLevels + 1 && (std::get<kLevels>(*pools_).Deallocate(memory), true)) || ...);
+    }
+
+    template <typename... Args>
+    Node* CreateNode(size_t height, Args&&... args) {
+        if (!pools_) {
+            pools_ = std::make_unique<Pools>();
+        }
+
+        void* memory = AllocateTower(height, std::make_index_sequence<kMaxLevel>{});
+        Node* node = nullptr;
+        try {
+            node = new (memory) Node(height, std::forward<Args>(args)...);
+        } catch (...) {
+            DeallocateTower(memory, height, std::make_index_sequence<kMaxLevel>{});
+            throw;
+        }
+
+        std::fill_n(node->Next(), height, nullptr);
+        return node;
+    }
+
+    void DestroyNode(Node* node) noexcept {
+        const size_t height = node->height;
+        node->~Node();
+        DeallocateTower(node, height, std::make_index_sequence<kMaxLevel>{});
+    }
+
+private:
+    std::array<Node*, kMaxLevel> head_next_{};
+    size_t level_ = 1;
+    size_t size_ = 0;
+    std::unique_ptr<Pools> pools_;
+    Compare comp_{};
+    std::minstd_rand random_;
+};
+
+template <typename Type, typename Compare>
+typename SkipList<Type, Compare>::Node** SkipList<Type, Compare>::Node::Next() const noexcept {
+    auto tower = reinterpret_cast<const unsigned char*>(this) + kTowerOffset;
+    return reinterpret_cast<Node**>(const_cast<unsigned char*>(tower));
+}
+
+template <typename Type, typename Compare>
+void swap(SkipList<Type, Compare>& left, SkipList<Type, Compare>& right) noexcept {
+    left.swap(right);
+}
+
+template <typename Type, typename Compare>
+bool operator==(const SkipList<Type, Compare>& left, const SkipList<Type, Compare>& right) {
+    if (&left == &right) {
+        return true;
+    }
+
+    if (left.GetSize() != right.GetSize()) {
+        return false;
+    }
+
+    return std::equal(left.begin(), left.end(), right.begin());
+}
+
+template <typename Type, typename Compare>
+bool operator!=(const SkipList<Type, Compare>& left, const SkipList<Type, Compare>& right) {
+    return !(left == right);
+}
+
+template <typename Type, typename Compare>
+bool operator<(const SkipList<Type, Compare>& left, const SkipList<Type, Compare>& right) {
+    return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
+}
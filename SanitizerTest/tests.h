@@ -0,0 +1,616 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "intrusive_list.h"
+#include "list.h"
+#include "skip_list.h"
+#include "unrolled_list.h"
+
+inline void TestListBasics() {
+    std::cout << "Test list basics" << std::endl;
+    SingleLinkedList<int> list{1, 2, 3};
+    assert(list.GetSize() == 3);
+    assert(*list.begin() == 1);
+
+    list.PushFront(0);
+    list.InsertAfter(list.cbegin(), 10);
+    assert((list == SingleLinkedList<int>{0, 10, 1, 2, 3}));
+
+    list.EraseAfter(list.cbegin());
+    list.PopFront();
+    assert((list == SingleLinkedList<int>{1, 2, 3}));
+
+    SingleLinkedList<int> copy(list);
+    assert(copy == list);
+    copy.PushFront(-1);
+    assert(copy != list && copy < list);
+
+    list = copy;
+    assert(list == copy);
+
+    list.Clear();
+    assert(list.IsEmpty());
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+inline void TestListNodePool() {
+    std::cout << "Test list node pool" << std::endl;
+    {
+        SingleLinkedList<int> list;
+        for (int i = 0; i < 100; ++i) {
+            list.PushFront(i);
+        }
+        const size_t capacity = list.GetPool()->GetCapacity();
+        assert(capacity >= 100);
+
+        // Освобождённые узлы переиспользуются без выделения новых блоков
+        list.Clear();
+        for (int i = 0; i < 100; ++i) {
+            list.PushFront(i);
+        }
+        assert(list.GetPool()->GetCapacity() == capacity);
+
+        // Последовательно созданные узлы лежат рядом в памяти
+        SingleLinkedList<int> fresh;
+        fresh.PushFront(1);
+        const int* first = &*fresh.begin();
+        fresh.PushFront(2);
+        const int* second = &*fresh.begin();
+        assert(second != first);
+        assert(static_cast<size_t>(std::abs(reinterpret_cast<const char*>(second) - reinterpret_cast<const char*>(first)))
+               == sizeof(SingleLinkedList<int>::Node));
+    }
+    {
+        // Списки могут разделять один пул
+        SingleLinkedList<std::string> first;
+        first.PushFront("a");
+        SingleLinkedList<std::string> second(first.GetPool());
+        second.PushFront("b");
+        assert(second.GetPool() == first.GetPool());
+
+        first.Clear();
+        second.PushFront("c");
+        assert(first.GetPool()->GetCapacity() == NodePool<SingleLinkedList<std::string>::Node>::kInitialBlockSize);
+
+        // Копирующее присваивание сохраняет разделяемый пул
+        const SingleLinkedList<std::string> source{"x", "y"};
+        second = source;
+        assert(second.GetPool() == first.GetPool());
+    }
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+template <size_t kNodeCapacity>
+void CheckUnrolledListAgainstList() {
+    // Одни и те же операции над обычным и развёрнутым списком дают одинаковый результат
+    SingleLinkedList<int> expected;
+    UnrolledSingleLinkedList<int, kNodeCapacity> list;
+
+    for (int i = 0; i < 50; ++i) {
+        expected.PushFront(i);
+        list.PushFront(i);
+    }
+
+    auto expected_it = expected.before_begin();
+    auto it = list.before_begin();
+    for (int i = 0; i < 30; ++i) {
+        ++expected_it;
+        ++it;
+        if (i % 3 == 0) {
+            expected_it = expected.InsertAfter(expected_it, 100 + i);
+            it = list.InsertAfter(it, 100 + i);
+        }
+        if (i % 4 == 0) {
+            expected.EraseAfter(expected_it);
+            list.EraseAfter(it);
+        }
+    }
+    assert(list.GetSize() == expected.GetSize());
+    assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+
+    while (!expected.IsEmpty()) {
+        expected.PopFront();
+        list.PopFront();
+        assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+    }
+    assert(list.IsEmpty() && list.begin() == list.end());
+}
+
+inline void TestUnrolledList() {
+    std::cout << "Test unrolled list" << std::endl;
+    static_assert(sizeof(UnrolledSingleLinkedList<int>::Node) == kUnrolledNodeSize);
+    static_assert(UnrolledSingleLinkedList<int>::kCapacity > 1);
+
+    CheckUnrolledListAgainstList<1>();
+    CheckUnrolledListAgainstList<2>();
+    CheckUnrolledListAgainstList<5>();
+    CheckUnrolledListAgainstList<kDefaultUnrolledCapacity<int>>();
+
+    UnrolledSingleLinkedList<std::string> strings{"a", "b", "c"};
+    UnrolledSingleLinkedList<std::string> copy(strings);
+    assert(copy == strings);
+    copy.InsertAfter(copy.cbegin(), "x");
+    assert(copy != strings);
+    assert((copy == UnrolledSingleLinkedList<std::string>{"a", "x", "b", "c"}));
+    strings = copy;
+    assert(strings == copy);
+
+    {
+        // Перемещение, выбрасывающее исключение, не нарушает согласованность размера
+        // списка и числа элементов в узлах
+        struct ThrowingMove {
+            ThrowingMove(int number, int* moves_left): value(number), moves(moves_left) {}
+            ThrowingMove(const ThrowingMove&) = default;
+            ThrowingMove(ThrowingMove&& other): value(other.value), moves(other.moves) {
+                CountMove();
+            }
+            ThrowingMove& operator=(const ThrowingMove&) = default;
+            ThrowingMove& operator=(ThrowingMove&& other) {
+                value = other.value;
+                moves = other.moves;
+                CountMove();
+                return *this;
+            }
+            void CountMove() {
+                if (moves != nullptr && (*moves)-- == 0) {
+                    throw std::runtime_error("move failed");
+                }
+            }
+            int value;
+            int* moves;
+        };
+
+        for (int moves_before_throw = 0; moves_before_throw < 4; ++moves_before_throw) {
+            int moves_left = -1;
+            UnrolledSingleLinkedList<ThrowingMove, 4> list;
+            auto last = list.cbefore_begin();
+            for (int i = 0; i < 4; ++i) {
+                last = list.InsertAfter(last, ThrowingMove(i, &moves_left));
+            }
+
+            // Вставка в середину полного узла делит его, затем сдвигает элементы
+            moves_left = moves_before_throw;
+            try {
+                list.InsertAfter(list.cbegin(), ThrowingMove(10, nullptr));
+            } catch (const std::runtime_error&) {
+            }
+            moves_left = -1;
+            assert(list.GetSize() == 4 || list.GetSize() == 5);
+            assert(static_cast<size_t>(std::distance(list.begin(), list.end())) == list.GetSize());
+        }
+    }
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+inline void TestListMoveAndEmplace() {
+    std::cout << "Test list move and emplace" << std::endl;
+    {
+        // Вспомогательный "шпион", считающий копирования
+        struct CopyCounter {
+            CopyCounter() = default;
+            explicit CopyCounter(int* counter): copies(counter) {}
+            CopyCounter(const CopyCounter& other): copies(other.copies) {
+                if (copies != nullptr) {
+                    ++*copies;
+                }
+            }
+            CopyCounter(CopyCounter&&) noexcept = default;
+            CopyCounter& operator=(const CopyCounter&) = default;
+            CopyCounter& operator=(CopyCounter&&) noexcept = default;
+            int* copies = nullptr;
+        };
+
+        int copies = 0;
+        SingleLinkedList<CopyCounter> list;
+        list.PushFront(CopyCounter(&copies));
+        list.InsertAfter(list.cbegin(), CopyCounter(&copies));
+        list.EmplaceFront(&copies);
+        list.EmplaceAfter(list.cbegin(), &copies);
+        assert(list.GetSize() == 4);
+        assert(copies == 0);
+
+        CopyCounter lvalue(&copies);
+        list.PushFront(lvalue);
+        assert(copies == 1);
+    }
+    {
+        // Список поддерживает некопируемые типы
+        SingleLinkedList<std::unique_ptr<int>> list;
+        list.PushFront(std::make_unique<int>(2));
+        auto& first = list.EmplaceFront(new int(1));
+        assert(*first == 1);
+        auto it = list.EmplaceAfter(list.cbegin(), std::make_unique<int>(5));
+        assert(**it == 5);
+        list.InsertAfter(it, std::make_unique<int>(6));
+
+        SingleLinkedList<std::unique_ptr<int>> moved(std::move(list));
+        assert(list.IsEmpty());
+        assert(moved.GetSize() == 4);
+
+        list = std::move(moved);
+        assert(moved.IsEmpty());
+        int expected[] = {1, 5, 6, 2};
+        assert(std::equal(list.begin(), list.end(), std::begin(expected), [](const auto& ptr, int value) {
+            return *ptr == value;
+        }));
+    }
+    {
+        SingleLinkedList<std::string> list;
+        auto& value = list.EmplaceFront(3, 'a');
+        assert(value == "aaa");
+        std::string text = "moved";
+        list.PushFront(std::move(text));
+        assert(*list.begin() == "moved");
+    }
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+inline void TestListSpliceAndSort() {
+    std::cout << "Test list splice and sort" << std::endl;
+    {
+        // Списки с общим пулом обмениваются узлами без копирования
+        SingleLinkedList<int> first{1, 2, 3};
+        SingleLinkedList<int> second(first.GetPool());
+        second.PushFront(20);
+        second.PushFront(10);
+        const int* ten = &*second.begin();
+
+        first.SpliceAfter(first.cbegin(), second, second.cbefore_begin());
+        assert((first == SingleLinkedList<int>{1, 10, 2, 3}));
+        assert((second == SingleLinkedList<int>{20}));
+        assert(&*std::next(first.begin()) == ten);
+
+        first.SpliceAfter(first.cbefore_begin(), second);
+        assert((first == SingleLinkedList<int>{20, 1, 10, 2, 3}));
+        assert(second.IsEmpty());
+
+        // Перенос интервала внутри одного списка
+        auto before_first = first.cbegin();
+        first.SpliceAfter(first.cbefore_begin(), first, before_first, std::next(before_first, 3));
+        assert((first == SingleLinkedList<int>{1, 10, 20, 2, 3}));
+        assert(first.GetSize() == 5);
+
+        // В пустой список узлы переносятся без копирования
+        SingleLinkedList<int> empty;
+        const int* one = &*first.begin();
+        empty.SpliceAfter(empty.cbefore_begin(), first);
+        assert(&*empty.begin() == one);
+        assert(empty.GetSize() == 5 && first.IsEmpty());
+    }
+    {
+        // Независимо созданные списки тоже обмениваются узлами без копирования
+        // и без выделения новых узлов: их пулы объединяются
+        SingleLinkedList<std::string> first{"a", "d"};
+        const size_t first_capacity = first.GetPool()->GetCapacity();
+        const std::string* b = nullptr;
+        size_t joined_capacity = 0;
+        {
+            SingleLinkedList<std::string> second{"b", "c"};
+            const size_t second_capacity = second.GetPool()->GetCapacity();
+            b = &*second.begin();
+
+            first.SpliceAfter(first.cbegin(), second);
+            assert((first == SingleLinkedList<std::string>{"a", "b", "c", "d"}));
+            assert(second.IsEmpty());
+            assert(&*std::next(first.begin()) == b);
+            assert(first.GetPool() == second.GetPool());
+            joined_capacity = first.GetPool()->GetCapacity();
+            assert(joined_capacity == first_capacity + second_capacity);
+
+            // Обмен в обратную сторону
+            second.SpliceAfter(second.cbefore_begin(), first, first.cbegin());
+            assert((second == SingleLinkedList<std::string>{"b"}));
+            assert(&*second.begin() == b);
+            second.SpliceAfter(second.cbefore_begin(), first, first.cbefore_begin());
+            assert((second == SingleLinkedList<std::string>{"a", "b"}));
+            first.SpliceAfter(first.cbefore_begin(), second);
+            assert((first == SingleLinkedList<std::string>{"a", "b", "c", "d"}));
+            assert(first.GetPool()->GetCapacity() == joined_capacity);
+        }
+        // Список second разрушен, а его узлы остаются в first
+        assert(*std::next(first.begin()) == "b");
+        assert(&*std::next(first.begin()) == b);
+
+        SingleLinkedList<std::string> other{"bb", "e"};
+        const std::string* bb = &*other.begin();
+        const size_t other_capacity = other.GetPool()->GetCapacity();
+        first.Merge(other);
+        assert((first == SingleLinkedList<std::string>{"a", "b", "bb", "c", "d", "e"}));
+        assert(other.IsEmpty());
+        assert(&*std::next(first.begin(), 2) == bb);
+        joined_capacity += other_capacity;
+        assert(first.GetPool()->GetCapacity() == joined_capacity);
+
+        // Узлы, освобождённые одним списком, переиспользуются другим
+        first.Clear();
+        for (int i = 0; i < 6; ++i) {
+            other.PushFront("x");
+        }
+        assert(first.GetPool()->GetCapacity() == joined_capacity);
+    }
+    {
+        // Список, разделявший пул с присоединённым, продолжает работать через общий пул
+        SingleLinkedList<int> first{1};
+        SingleLinkedList<int> second{2};
+        SingleLinkedList<int> neighbour(second.GetPool());
+        neighbour.PushFront(3);
+
+        first.SpliceAfter(first.cbefore_begin(), second);
+        neighbour.SpliceAfter(neighbour.cbefore_begin(), first);
+        assert((neighbour == SingleLinkedList<int>{2, 1, 3}));
+        assert(first.IsEmpty());
+        second.PushFront(4);
+        neighbour.Clear();
+        first.PushFront(5);
+        assert(first.GetPool()->GetCapacity() == second.GetPool()->GetCapacity());
+    }
+    {
+        // Постоянный перенос узлов из временного списка не копит память
+        SingleLinkedList<int> queue{0};
+        SingleLinkedList<int> temp;
+        size_t capacity = 0;
+        for (int i = 0; i < 100000; ++i) {
+            temp.PushFront(i);
+            queue.SpliceAfter(queue.cbefore_begin(), temp);
+            queue.PopFront();
+            if (i == 0) {
+                capacity = queue.GetPool()->GetCapacity();
+            }
+        }
+        assert((queue == SingleLinkedList<int>{0}));
+        assert(temp.IsEmpty());
+        assert(queue.GetPool()->GetCapacity() == capacity);
+        assert(temp.GetPool()->GetCapacity() == capacity);
+    }
+    {
+        SingleLinkedList<int> first{1, 4, 6};
+        SingleLinkedList<int> second(first.GetPool());
+        second.PushFront(5);
+        second.PushFront(4);
+        second.PushFront(0);
+        first.Merge(second);
+        assert((first == SingleLinkedList<int>{0, 1, 4, 4, 5, 6}));
+        assert(first.GetSize() == 6 && second.IsEmpty());
+
+        first.Reverse();
+        assert((first == SingleLinkedList<int>{6, 5, 4, 4, 1, 0}));
+
+        assert(first.Unique() == 1);
+        assert((first == SingleLinkedList<int>{6, 5, 4, 1, 0}));
+
+        first.Sort();
+        assert((first == SingleLinkedList<int>{0, 1, 4, 5, 6}));
+    }
+    {
+        // Сортировка устойчива и не выделяет памяти
+        std::vector<std::pair<int, int>> values;
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back({(i * 7919) % 13, i});
+        }
+        SingleLinkedList<std::pair<int, int>> list;
+        auto last = list.cbefore_begin();
+        for (const auto& value : values) {
+            last = list.InsertAfter(last, value);
+        }
+        const size_t capacity = list.GetPool()->GetCapacity();
+
+        auto by_key = [](const auto& left, const auto& right) {
+            return left.first < right.first;
+        };
+        list.Sort(by_key);
+        std::stable_sort(values.begin(), values.end(), by_key);
+        assert(std::equal(list.begin(), list.end(), values.begin(), values.end()));
+        assert(list.GetSize() == values.size());
+        assert(list.GetPool()->GetCapacity() == capacity);
+
+        SingleLinkedList<int> empty;
+        empty.Sort();
+        empty.Reverse();
+        assert(empty.IsEmpty());
+    }
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+inline void TestListAssignmentReusesNodes() {
+    std::cout << "Test list assignment reuses nodes" << std::endl;
+    {
+        SingleLinkedList<int> list{1, 2, 3};
+        const int* first = &*list.begin();
+        const size_t capacity = list.GetPool()->GetCapacity();
+
+        // Список того же размера перезаписывается на месте
+        const SingleLinkedList<int> same_size{4, 5, 6};
+        list = same_size;
+        assert(list == same_size);
+        assert(&*list.begin() == first);
+        assert(list.GetPool()->GetCapacity() == capacity);
+
+        // Более короткий список освобождает лишние узлы
+        const SingleLinkedList<int> shorter{7};
+        list = shorter;
+        assert(list == shorter);
+        assert(&*list.begin() == first);
+
+        // Более длинный список дополняется новыми узлами
+        const SingleLinkedList<int> longer{8, 9, 10, 11, 12};
+        list = longer;
+        assert(list == longer);
+        assert(&*list.begin() == first);
+
+        const SingleLinkedList<int> empty;
+        list = empty;
+        assert(list.IsEmpty());
+        list = longer;
+        assert(list == longer);
+    }
+    {
+        // Копия и список из initializer_list размещают узлы одним блоком
+        SingleLinkedList<int> list{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+        SingleLinkedList<int> copy(list);
+        for (auto* current : {&list, &copy}) {
+            assert(current->GetPool()->GetCapacity() == current->GetSize());
+            auto it = current->begin();
+            for (auto next = std::next(it); next != current->end(); ++it, ++next) {
+                assert(reinterpret_cast<const char*>(&*next) - reinterpret_cast<const char*>(&*it)
+                       == static_cast<std::ptrdiff_t>(sizeof(SingleLinkedList<int>::Node)));
+            }
+        }
+    }
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+inline void TestIntrusiveList() {
+    std::cout << "Test intrusive list" << std::endl;
+
+    struct ByOrder {};
+    struct ByPriority {};
+    // Объект может одновременно состоять в двух списках
+    struct Task : IntrusiveListHook<ByOrder>, IntrusiveListHook<ByPriority> {
+        explicit Task(int task_id): id(task_id) {}
+        int id;
+    };
+
+    std::vector<Task> storage;
+    for (int i = 0; i < 5; ++i) {
+        storage.emplace_back(i);
+    }
+
+    IntrusiveSingleLinkedList<Task, ByOrder> in_order;
+    IntrusiveSingleLinkedList<Task, ByPriority> by_priority;
+    {
+        auto last = in_order.cbefore_begin();
+        for (Task& task : storage) {
+            last = in_order.InsertAfter(last, task);
+            by_priority.PushFront(task);
+        }
+    }
+    assert(in_order.GetSize() == 5 && by_priority.GetSize() == 5);
+
+    // Элементы списка - это сами объекты, без копирования
+    assert(&*in_order.begin() == &storage[0]);
+    assert(&*by_priority.begin() == &storage[4]);
+
+    auto ids = [](const auto& list) {
+        std::vector<int> result;
+        for (const Task& task : list) {
+            result.push_back(task.id);
+        }
+        return result;
+    };
+    assert((ids(in_order) == std::vector<int>{0, 1, 2, 3, 4}));
+    assert((ids(by_priority) == std::vector<int>{4, 3, 2, 1, 0}));
+
+    // Удаление из одного списка не затрагивает другой
+    auto next = in_order.EraseAfter(in_order.cbegin());
+    assert(next->id == 2);
+    in_order.PopFront();
+    assert((ids(in_order) == std::vector<int>{2, 3, 4}));
+    assert(by_priority.GetSize() == 5);
+
+    // Отцепленный объект можно снова вставить
+    in_order.PushFront(storage[0]);
+    assert((ids(in_order) == std::vector<int>{0, 2, 3, 4}));
+
+    IntrusiveSingleLinkedList<Task, ByOrder> moved(std::move(in_order));
+    assert(in_order.IsEmpty() && moved.GetSize() == 4);
+
+    moved.Clear();
+    by_priority.Clear();
+    assert(moved.IsEmpty() && moved.begin() == moved.end());
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+inline void TestSkipList() {
+    std::cout << "Test skip list" << std::endl;
+    {
+        SkipList<int> set{5, 1, 3};
+        assert(set.GetSize() == 3);
+        assert(set.Contains(3) && !set.Contains(2));
+
+        auto [it, inserted] = set.Insert(2);
+        assert(inserted && *it == 2);
+        assert(!set.Insert(2).second);
+        assert(set.GetSize() == 4);
+
+        // Обход идёт в порядке возрастания
+        SingleLinkedList<int> expected{1, 2, 3, 5};
+        assert(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+
+        assert(*set.LowerBound(4) == 5);
+        assert(set.LowerBound(6) == set.end());
+        assert(set.Find(4) == set.end());
+
+        assert(set.Erase(3) == 1);
+        assert(set.Erase(3) == 0);
+        assert((set == SkipList<int>{1, 2, 5}));
+
+        SkipList<int> copy(set);
+        assert(copy == set);
+        copy.Insert(0);
+        assert(copy < set);
+
+        SkipList<int> moved(std::move(copy));
+        assert(copy.IsEmpty() && moved.GetSize() == 4);
+    }
+    {
+        // Сравнение с std::set на случайных операциях
+        SkipList<int, std::greater<int>> list;
+        std::set<int, std::greater<int>> expected;
+        std::minstd_rand random;
+        for (int i = 0; i < 20000; ++i) {
+            const int value = static_cast<int>(random() % 2000);
+            if (random() % 3 == 0) {
+                assert(list.Erase(value) == expected.erase(value));
+            } else {
+                assert(list.Insert(value).second == expected.insert(value).second);
+            }
+        }
+        assert(list.GetSize() == expected.size());
+        assert(std::equal(list.begin(), list.end(), expected.begin(), expected.end()));
+
+        SkipList<int, std::greater<int>> copy;
+        copy = list;
+        assert(std::equal(copy.begin(), copy.end(), expected.begin(), expected.end()));
+        list.Clear();
+        assert(list.IsEmpty() && list.begin() == list.end());
+    }
+    {
+        SkipList<std::string> strings;
+        std::string value = "b";
+        strings.Insert(std::move(value));
+        strings.Insert("a");
+        assert(*strings.begin() == "a");
+        assert(strings.Contains("b"));
+    }
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+inline void TestListPrefetchingIteration() {
+    std::cout << "Test list prefetching iteration" << std::endl;
+    SingleLinkedList<int> list{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    assert(std::equal(list.PrefetchingBegin(), list.PrefetchingEnd(), list.begin(), list.end()));
+    assert(std::equal(list.PrefetchingBegin<1>(), list.PrefetchingEnd<1>(), list.begin(), list.end()));
+
+    SingleLinkedList<int> copy(list);
+    assert(PrefetchingEqual(list, copy));
+    assert(!PrefetchingLess(list, copy));
+
+    copy.EraseAfter(std::next(copy.cbegin(), 8));
+    assert(!PrefetchingEqual(list, copy));
+    assert(PrefetchingLess(copy, list));
+
+    SingleLinkedList<int> empty;
+    assert(empty.PrefetchingBegin() == empty.PrefetchingEnd());
+    assert(PrefetchingLess(empty, list));
+    std::cout << "Done!" << std::endl << std::endl;
+}
@@ -0,0 +1,413 @@
+#pragma once
+
+#include <iterator>
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <new>
+#include <utility>
+
+inline constexpr size_t kUnrolledNodeSize = 64;
+
+// Количество элементов в узле по умолчанию: столько, чтобы узел занимал одну строку кэша
+template <typename Type>
+inline constexpr size_t kDefaultUnrolledCapacity =
+    std::max<size_t>(1, (kUnrolledNodeSize - sizeof(void*) - sizeof(size_t)) / sizeof(Type));
+
+// Односвязный список, хранящий в каждом узле до kNodeCapacity элементов.
+// Интерфейс повторяет SingleLinkedList: before_begin, InsertAfter, EraseAfter.
+// Итераторы становятся недействительными при вставке и удалении элементов того же узла
+template <typename Type, size_t kNodeCapacity = kDefaultUnrolledCapacity<Type>>
+class UnrolledSingleLinkedList {
+    static_assert(kNodeCapacity > 0);
+
+public:
+    struct alignas(kUnrolledNodeSize) Node {
+        Node() = default;
+
+        Node(const Node&) = delete;
+        Node& operator=(const Node&) = delete;
+
+        ~Node() {
+            for (size_t i = 0; i < count; ++i) {
+                Value(i).~Type();
+            }
+        }
+
+        Type& Value(size_t index) noexcept {
+            return reinterpret_cast<Type*>(storage)[index];
+        }
+
+        Node* next_node = nullptr;
+        size_t count = 0;
+        alignas(Type) unsigned char storage[sizeof(Type) * kNodeCapacity];
+    };
+
+    template <typename ValueType>
+    class BasicIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = ValueType*;
+        using reference = ValueType&;
+
+    public:
+        friend class UnrolledSingleLinkedList;
+
+        BasicIterator() = default;
+
+        BasicIterator(const BasicIterator<Type>& other) noexcept
+        : node_(other.node_)
+        , index_(other.index_) {
+        }
+
+        BasicIterator(Node* node, size_t index) noexcept
+        : node_(node)
+        , index_(index) {
+        }
+
+        BasicIterator& operator=(const BasicIterator& right) = default;
+
+    public:
+        [[nodiscard]] bool operator==(const BasicIterator<const Type>& right) const noexcept {
+            return node_ == right.node_ && index_ == right.index_;
+        }
+
+        [[nodiscard]] bool operator!=(const BasicIterator<const Type>& right) const noexcept {
+            return !(*this == right);
+        }
+
+        [[nodiscard]] bool operator==(const BasicIterator<Type>& right) const noexcept {
+            return node_ == right.node_ && index_ == right.index_;
+        }
+
+        [[nodiscard]] bool operator!=(const BasicIterator<Type>& right) const noexcept {
+            return !(*this == right);
+        }
+
+        // Узел before_begin пуст, поэтому из него переходим сразу в первый узел
+        BasicIterator& operator++() noexcept {
+            if (++index_ >= node_->count) {
+                node_ = node_->next_node;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            auto old_value(*this);
+            ++(*this);
+            return old_value;
+        }
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return node_->Value(index_);
+        }
+
+        [[nodiscard]] pointer operator->() const noexcept {
+            return &node_->Value(index_);
+        }
+
+    private:
+        Node* node_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using value_type = Type;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using Iterator = BasicIterator<Type>;
+    using ConstIterator = BasicIterator<const Type>;
+
+    static constexpr size_t kCapacity = kNodeCapacity;
+
+public:
+    UnrolledSingleLinkedList() = default;
+
+    UnrolledSingleLinkedList(std::initializer_list<Type> values) {
+        Assign(values.begin(), values.end());
+    }
+
+    UnrolledSingleLinkedList(const UnrolledSingleLinkedList& other) {
+        Assign(other.begin(), other.end());
+    }
+
+    ~UnrolledSingleLinkedList() {
+        Clear();
+    }
+
+    UnrolledSingleLinkedList& operator=(const UnrolledSingleLinkedList& right) {
+        if (this != &right) {
+            UnrolledSingleLinkedList temp(right);
+            swap(temp);
+        }
+
+        return *this;
+    }
+
+public:
+    [[nodiscard]] size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    void PushFront(const Type& value) {
+        InsertAfter(cbefore_begin(), value);
+    }
+
+    void PopFront() noexcept {
+        EraseAfter(cbefore_begin());
+    }
+
+    void Clear() noexcept {
+        while (head_.next_node) {
+            Node* current_node = head_.next_node;
+            head_.next_node = current_node->next_node;
+            delete current_node;
+        }
+        size_ = 0;
+    }
+
+    void swap(UnrolledSingleLinkedList& other) noexcept {
+        std::swap(head_.next_node, other.head_.next_node);
+        std::swap(size_, other.size_);
+    }
+
+    Iterator InsertAfter(ConstIterator before_inserted, const Type& value) {
+        Node* node = before_inserted.node_;
+        assert(node != nullptr);
+
+        // Предшественник узла, если под вставку создан новый пустой узел
+        Node* prev_node = nullptr;
+        size_t index = before_inserted.index_ + 1;
+        if (node == &head_) {
+            node = head_.next_node;
+            index = 0;
+            if (node == nullptr) {
+                prev_node = &head_;
+                node = InsertNodeAfter(&head_);
+            }
+        }
+
+        if (node->count == kNodeCapacity) {
+            if (index == kNodeCapacity) {
+                // Вставка в конец полного узла: начинаем новый узел, чтобы при
+                // последовательном заполнении узлы оставались полными
+                prev_node = node;
+                node = InsertNodeAfter(node);
+                index = 0;
+            } else if (index == 0) {
+                // Вставка в начало списка перед полным первым узлом
+                prev_node = &head_;
+                node = InsertNodeAfter(&head_);
+            } else {
+                Node* new_node = SplitNode(node);
+                if (index > node->count) {
+                    index -= node->count;
+                    node = new_node;
+                }
+            }
+        }
+
+        try {
+            InsertIntoNode(node, index, value);
+        } catch (...) {
+            // Пустые узлы в списке недопустимы
+            if (node->count == 0) {
+                prev_node->next_node = node->next_node;
+                delete node;
+            }
+            throw;
+        }
+        ++size_;
+
+        return Iterator{node, index};
+    }
+
+    Iterator EraseAfter(ConstIterator before_deleted) noexcept {
+        Node* prev_node = before_deleted.node_;
+        if (prev_node == nullptr) {
+            return Iterator{};
+        }
+
+        Node* node = prev_node;
+        size_t index = before_deleted.index_ + 1;
+        if (prev_node == &head_ || index >= prev_node->count) {
+            node = prev_node->next_node;
+            index = 0;
+        }
+
+        if (node == nullptr) {
+            return Iterator{};
+        }
+
+        for (size_t i = index + 1; i < node->count; ++i) {
+            node->Value(i - 1) = std::move(node->Value(i));
+        }
+        node->Value(node->count - 1).~Type();
+        --node->count;
+        --size_;
+
+        if (node->count == 0) {
+            // Узел опустел: он не совпадает с узлом before_deleted, значит prev_node - его предшественник
+            prev_node->next_node = node->next_node;
+            delete node;
+            return Iterator{prev_node->next_node, 0};
+        }
+
+        if (index < node->count) {
+            return Iterator{node, index};
+        }
+
+        return Iterator{node->next_node, 0};
+    }
+
+public:
+    [[nodiscard]] Iterator begin() noexcept {
+        return Iterator{head_.next_node, 0};
+    }
+
+    [[nodiscard]] Iterator end() noexcept {
+        return Iterator{nullptr, 0};
+    }
+
+    [[nodiscard]] ConstIterator begin() const noexcept {
+        return ConstIterator{head_.next_node, 0};
+    }
+
+    [[nodiscard]] ConstIterator end() const noexcept {
+        return ConstIterator{nullptr, 0};
+    }
+
+    [[nodiscard]] ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    [[nodiscard]] ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] Iterator before_begin() noexcept {
+        return Iterator{&head_, 0};
+    }
+
+    [[nodiscard]] ConstIterator cbefore_begin() const noexcept {
+        return ConstIterator{const_cast<Node*>(&head_), 0};
+    }
+
+    [[nodiscard]] ConstIterator before_begin() const noexcept {
+        return cbefore_begin();
+    }
+
+private:
+    template <typename InputIterator>
+    void Assign(InputIterator from, InputIterator to) {
+        UnrolledSingleLinkedList temp;
+
+        auto last = temp.before_begin();
+
+        for (auto it = from; it != to; ++it) {
+            last = temp.InsertAfter(last, *it);
+        }
+
+        swap(temp);
+    }
+
+    Node* InsertNodeAfter(Node* node) {
+        Node* new_node = new Node();
+        new_node->next_node = node->next_node;
+        node->next_node = new_node;
+        return new_node;
+    }
+
+    // Переносит верхнюю половину элементов полного узла в новый узел, возвращает новый узел.
+    // Если перенос элемента выбрасывает исключение, новый узел удаляется, а node
+    // сохраняет все элементы; копируемые типы с небросающим перемещением не теряют значений
+    Node* SplitNode(Node* node) {
+        Node* new_node = InsertNodeAfter(node);
+        const size_t keep = node->count / 2;
+
+        try {
+            for (size_t i = keep; i < node->count; ++i) {
+                new (&new_node->Value(new_node->count)) Type(std::move_if_noexcept(node->Value(i)));
+                ++new_node->count;
+            }
+        } catch (...) {
+            node->next_node = new_node->next_node;
+            delete new_node;
+            throw;
+        }
+        for (size_t i = keep; i < node->count; ++i) {
+            node->Value(i).~Type();
+        }
+        node->count = keep;
+
+        return new_node;
+    }
+
+    void InsertIntoNode(Node* node, size_t index, const Type& value) {
+        assert(node->count < kNodeCapacity && index <= node->count);
+
+        if (index == node->count) {
+            new (&node->Value(index)) Type(value);
+            ++node->count;
+            return;
+        }
+
+        // value может ссылаться на сдвигаемый элемент, поэтому копируем его заранее
+        Type copy(value);
+        new (&node->Value(node->count)) Type(std::move(node->Value(node->count - 1)));
+        // Новый элемент учитывается в count только после сдвига: если перемещение
+        // выбросит исключение, лишний элемент удаляется и count остаётся согласован с size_
+        try {
+            for (size_t i = node->count - 1; i > index; --i) {
+                node->Value(i) = std::move(node->Value(i - 1));
+            }
+            node->Value(index) = std::move(copy);
+        } catch (...) {
+            node->Value(node->count).~Type();
+            throw;
+        }
+        ++node->count;
+    }
+
+private:
+    Node head_{};
+    size_t size_ = 0;
+};
+
+template <typename Type, size_t kNodeCapacity>
+void swap(UnrolledSingleLinkedList<Type, kNodeCapacity>& left, UnrolledSingleLinkedList<Type, kNodeCapacity>& right) noexcept {
+    left.swap(right);
+}
+
+template <typename Type, size_t kNodeCapacity>
+bool operator==(const UnrolledSingleLinkedList<Type, kNodeCapacity>& left,
+                const UnrolledSingleLinkedList<Type, kNodeCapacity>& right) {
+    if (&left == &right) {
+        return true;
+    }
+
+    if (left.GetSize() != right.GetSize()) {
+        return false;
+    }
+
+    return std::equal(left.begin(), left.end(), right.begin());
+}
+
+template <typename Type, size_t kNodeCapacity>
+bool operator!=(const UnrolledSingleLinkedList<Type, kNodeCapacity>& left,
+                const UnrolledSingleLinkedList<Type, kNodeCapacity>& right) {
+    return !(left == right);
+}
+
+template <typename Type, size_t kNodeCapacity>
+bool operator<(const UnrolledSingleLinkedList<Type, kNodeCapacity>& left,
+               const UnrolledSingleLinkedList<Type, kNodeCapacity>& right) {
+    return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cassert>
+#include <stdexcept>
+
+// Политики проверки указателя при разыменовании ScopedPtr и IntrusivePtr
+
+// Выбрасывает std::logic_error при разыменовании нулевого указателя
+struct ThrowOnNullCheck {
+    static void Check(const void* ptr) {
+        if (ptr == nullptr) {
+            ThrowNullDereference();
+        }
+    }
+
+private:
+    // Вынесено в отдельную функцию, чтобы код выброса исключения
+    // не мешал встраиванию операторов разыменования
+    [[noreturn]] static void ThrowNullDereference() {
+        throw std::logic_error("points to nullptr");
+    }
+};
+
+// Проверяет указатель через assert: в отладочной сборке останавливает программу,
+// при NDEBUG проверка исчезает
+struct AssertNotNullCheck {
+    static void Check([[maybe_unused]] const void* ptr) noexcept {
+        assert(ptr != nullptr);
+    }
+};
+
+// Не проверяет указатель, разыменование нулевого указателя - неопределённое поведение
+struct UncheckedAccess {
+    static void Check(const void*) noexcept {
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "check_policy.h"
+
+// Политики подсчёта ссылок для RefCounted
+
+// Обычный счётчик: для объектов, которые разделяются владельцами в пределах одного потока.
+// Не требует атомарных операций
+class NonAtomicRefCount {
+public:
+    void Increment() noexcept {
+        ++count_;
+    }
+
+    // Возвращает количество ссылок после уменьшения
+    size_t Decrement() noexcept {
+        return --count_;
+    }
+
+    size_t Get() const noexcept {
+        return count_;
+    }
+
+private:
+    size_t count_ = 0;
+};
+
+// Атомарный счётчик: для объектов, владельцы которых находятся в разных потоках
+class AtomicRefCount {
+public:
+    void Increment() noexcept {
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t Decrement() noexcept {
+        return count_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    }
+
+    size_t Get() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> count_ = 0;
+};
+
+// Базовый класс для объектов, которыми владеет IntrusivePtr.
+// Счётчик ссылок хранится внутри самого объекта, поэтому не нужен
+// отдельный управляющий блок, как у std::shared_ptr
+template <typename Derived, typename RefCountPolicy = NonAtomicRefCount>
+class RefCounted {
+public:
+    void AddRef() const noexcept {
+        ref_count_.Increment();
+    }
+
+    // Уменьшает счётчик ссылок и удаляет объект, если ссылок не осталось
+    void ReleaseRef() const noexcept {
+        if (ref_count_.Decrement() == 0) {
+            delete static_cast<const Derived*>(this);
+        }
+    }
+
+    size_t GetRefCount() const noexcept {
+        return ref_count_.Get();
+    }
+
+protected:
+    RefCounted() = default;
+
+    // Копия объекта получает собственный счётчик ссылок
+    RefCounted(const RefCounted&) noexcept {
+    }
+
+    RefCounted& operator=(const RefCounted&) noexcept {
+        return *this;
+    }
+
+    ~RefCounted() = default;
+
+private:
+    mutable RefCountPolicy ref_count_;
+};
+
+// Умный указатель с совместным владением объектом, унаследованным от RefCounted.
+// CheckPolicy определяет проверку указателя в operator* и operator->, как у ScopedPtr
+template <typename T, typename CheckPolicy = ThrowOnNullCheck>
+class IntrusivePtr {
+public:
+    IntrusivePtr() = default;
+
+    explicit IntrusivePtr(T* raw_ptr) noexcept
+        : ptr_(raw_ptr) {
+        if (ptr_ != nullptr) {
+            ptr_->AddRef();
+        }
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept
+        : IntrusivePtr(other.ptr_) {
+    }
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept
+        : ptr_(std::exchange(other.ptr_, nullptr)) {
+    }
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~IntrusivePtr() {
+        if (ptr_ != nullptr) {
+            ptr_->ReleaseRef();
+        }
+        ptr_ = nullptr;
+    }
+
+public:
+    T* GetRawPtr() const noexcept {
+        return ptr_;
+    }
+
+    // Количество указателей, владеющих объектом, либо 0 для пустого указателя
+    size_t GetUseCount() const noexcept {
+        return ptr_ == nullptr ? 0 : ptr_->GetRefCount();
+    }
+
+    void Reset(T* raw_ptr = nullptr) noexcept {
+        IntrusivePtr(raw_ptr).swap(*this);
+    }
+
+    void swap(IntrusivePtr& other) noexcept {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    explicit operator bool() const noexcept {
+        return ptr_ != nullptr;
+    }
+
+    T& operator*() const noexcept(noexcept(CheckPolicy::Check(nullptr))) {
+        CheckPolicy::Check(ptr_);
+        return *ptr_;
+    }
+
+    T* operator->() const noexcept(noexcept(CheckPolicy::Check(nullptr))) {
+        CheckPolicy::Check(ptr_);
+        return ptr_;
+    }
+
+private:
+    T* ptr_ = nullptr;
+};
+
+template <typename T, typename CheckPolicy>
+void swap(IntrusivePtr<T, CheckPolicy>& left, IntrusivePtr<T, CheckPolicy>& right) noexcept {
+    left.swap(right);
+}
+
+template <typename T, typename CheckPolicy>
+bool operator==(const IntrusivePtr<T, CheckPolicy>& left, const IntrusivePtr<T, CheckPolicy>& right) noexcept {
+    return left.GetRawPtr() == right.GetRawPtr();
+}
+
+template <typename T, typename CheckPolicy>
+bool operator!=(const IntrusivePtr<T, CheckPolicy>& left, const IntrusivePtr<T, CheckPolicy>& right) noexcept {
+    return !(left == right);
+}
+
+// Проверяет разыменование только в отладочной сборке, как DebugCheckedScopedPtr
+template <typename T>
+using DebugCheckedIntrusivePtr = IntrusivePtr<T, AssertNotNullCheck>;
@@ -2,7 +2,9 @@
 #include <stdexcept>
 #include <string>
 #include <iostream>
+#include <vector>
 
+#include "intrusive_pointer.h"
 #include "scoped_pointer.h"
 
 using namespace std;
@@ -110,6 +112,128 @@ int main() {
         }
     }
 
+    // Проверка пользовательского удалителя
+    {
+        // Удалитель без состояния не увеличивает размер умного указателя
+        struct NoopDeleter {
+            void operator()(int*) const noexcept {
+            }
+        };
+        static_assert(sizeof(ScopedPtr<int>) == sizeof(int*));
+        static_assert(sizeof(ScopedPtr<int, NoopDeleter>) == sizeof(int*));
+
+        // Удалитель, возвращающий объект в пул вместо вызова delete
+        struct Pool {
+            int slots[2] = {};
+            int released = 0;
+        };
+        struct PoolDeleter {
+            Pool* pool = nullptr;
+            void operator()(int*) const noexcept {
+                ++pool->released;
+            }
+        };
+
+        Pool pool;
+        {
+            ScopedPtr<int, PoolDeleter> p(&pool.slots[0], PoolDeleter{&pool});
+            assert(p.GetDeleter().pool == &pool);
+            *p = 42;
+            ScopedPtr<int, PoolDeleter> empty_ptr(nullptr, PoolDeleter{&pool});
+        }
+        // Для пустого указателя удалитель не вызывается
+        assert(pool.released == 1);
+        assert(pool.slots[0] == 42);
+
+        {
+            ScopedPtr<int, PoolDeleter> p(&pool.slots[1], PoolDeleter{&pool});
+            assert(p.Release() == &pool.slots[1]);
+        }
+        assert(pool.released == 1);
+    }
+
+    // Проверка политик проверки разыменования
+    {
+        static_assert(!noexcept(*ScopedPtr<int>()));
+        static_assert(noexcept(*DebugCheckedScopedPtr<int>()));
+        static_assert(noexcept(*ScopedPtr<int, default_delete<int>, UncheckedAccess>()));
+
+        DebugCheckedScopedPtr<string> debug_checked_ptr(new string("hello"s));
+        assert(debug_checked_ptr->size() == 5);
+        assert(*debug_checked_ptr == "hello"s);
+
+        ScopedPtr<string, default_delete<string>, UncheckedAccess> unchecked_ptr(new string("world"s));
+        assert(unchecked_ptr->size() == 5);
+        assert(*unchecked_ptr == "world"s);
+    }
+
+    // Проверка совместного владения через IntrusivePtr
+    {
+        struct SharedSpy : RefCounted<SharedSpy> {
+            explicit SharedSpy(bool& is_deleted)
+                : is_deleted_(is_deleted) {
+            }
+            ~SharedSpy() {
+                is_deleted_ = true;
+            }
+            bool& is_deleted_;
+        };
+        // Счётчик ссылок встроен в объект, указатель остаётся размером с сырой
+        static_assert(sizeof(IntrusivePtr<SharedSpy>) == sizeof(SharedSpy*));
+
+        bool is_deleted = false;
+        {
+            IntrusivePtr<SharedSpy> first(new SharedSpy(is_deleted));
+            assert(first.GetUseCount() == 1);
+            {
+                IntrusivePtr<SharedSpy> second(first);
+                assert(second == first);
+                assert(first.GetUseCount() == 2);
+
+                // Из сырого указателя можно восстановить владение без нового управляющего блока
+                IntrusivePtr<SharedSpy> third(second.GetRawPtr());
+                assert(first.GetUseCount() == 3);
+
+                IntrusivePtr<SharedSpy> moved(std::move(third));
+                assert(!third);
+                assert(first.GetUseCount() == 3);
+            }
+            assert(first.GetUseCount() == 1);
+            assert(!is_deleted);
+
+            first = first;
+            assert(first.GetUseCount() == 1);
+        }
+        assert(is_deleted);
+
+        struct AtomicCounted : RefCounted<AtomicCounted, AtomicRefCount> {
+        };
+        IntrusivePtr<AtomicCounted> atomic_ptr(new AtomicCounted());
+        IntrusivePtr<AtomicCounted> other_atomic_ptr;
+        other_atomic_ptr = atomic_ptr;
+        assert(atomic_ptr.GetUseCount() == 2);
+        other_atomic_ptr.Reset();
+        assert(atomic_ptr.GetUseCount() == 1);
+        assert(other_atomic_ptr.GetUseCount() == 0);
+
+        try {
+            IntrusivePtr<AtomicCounted> empty_ptr;
+            *empty_ptr;
+            assert(false);
+        } catch (const logic_error&) {
+        }
+
+        // Политики проверки разыменования те же, что у ScopedPtr
+        static_assert(!noexcept(*IntrusivePtr<AtomicCounted>()));
+        static_assert(noexcept(*DebugCheckedIntrusivePtr<AtomicCounted>()));
+        static_assert(noexcept(*IntrusivePtr<AtomicCounted, UncheckedAccess>()));
+        static_assert(sizeof(IntrusivePtr<AtomicCounted, UncheckedAccess>) == sizeof(AtomicCounted*));
+
+        DebugCheckedIntrusivePtr<AtomicCounted> debug_checked_ptr(atomic_ptr.GetRawPtr());
+        assert(&*debug_checked_ptr == atomic_ptr.GetRawPtr());
+        assert(atomic_ptr.GetUseCount() == 2);
+    }
+
     // Пример использования
     {
         // На этой структуре будет проверяться работа умного указателя
@@ -1,12 +1,67 @@
 #pragma once
 
+#include <cassert>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+
+#include "check_policy.h"
 
 using namespace std::literals;
 
-template <typename T>
-class ScopedPtr {
+namespace scoped_ptr_detail {
+
+// Хранит удалитель. Пустой (stateless) удалитель хранится как базовый класс,
+// благодаря оптимизации пустой базы он не занимает места в ScopedPtr
+template <typename Deleter, bool kIsEmptyBase = std::is_empty_v<Deleter> && !std::is_final_v<Deleter>>
+class DeleterHolder : private Deleter {
+public:
+    DeleterHolder() = default;
+
+    explicit DeleterHolder(const Deleter& deleter)
+        : Deleter(deleter) {
+    }
+
+    Deleter& GetDeleter() noexcept {
+        return *this;
+    }
+
+    const Deleter& GetDeleter() const noexcept {
+        return *this;
+    }
+};
+
+template <typename Deleter>
+class DeleterHolder<Deleter, false> {
+public:
+    DeleterHolder() = default;
+
+    explicit DeleterHolder(const Deleter& deleter)
+        : deleter_(deleter) {
+    }
+
+    Deleter& GetDeleter() noexcept {
+        return deleter_;
+    }
+
+    const Deleter& GetDeleter() const noexcept {
+        return deleter_;
+    }
+
+private:
+    Deleter deleter_{};
+};
+
+} // namespace scoped_ptr_detail
+
+// Deleter вызывается как deleter(ptr) для ненулевого указателя при разрушении ScopedPtr.
+// Позволяет возвращать объекты в пул или арену вместо вызова delete
+// CheckPolicy определяет проверку указателя в operator* и operator->
+template <typename T, typename Deleter = std::default_delete<T>, typename CheckPolicy = ThrowOnNullCheck>
+class ScopedPtr : private scoped_ptr_detail::DeleterHolder<Deleter> {
+    using DeleterBase = scoped_ptr_detail::DeleterHolder<Deleter>;
+
 public:
     ScopedPtr() = default;
 
@@ -14,10 +69,17 @@ public:
         ptr_ = raw_ptr;
     }
 
+    ScopedPtr(T* raw_ptr, const Deleter& deleter)
+        : DeleterBase(deleter)
+        , ptr_(raw_ptr) {
+    }
+
     ScopedPtr(const ScopedPtr&) = delete;
 
     ~ScopedPtr() {
-        delete ptr_;
+        if (ptr_ != nullptr) {
+            GetDeleter()(ptr_);
+        }
         ptr_ = nullptr;
     }
 
@@ -26,6 +88,14 @@ public:
         return ptr_;
     }
 
+    Deleter& GetDeleter() noexcept {
+        return DeleterBase::GetDeleter();
+    }
+
+    const Deleter& GetDeleter() const noexcept {
+        return DeleterBase::GetDeleter();
+    }
+
     T* Release() noexcept {
         auto temp = ptr_;
         ptr_ = nullptr;
@@ -36,18 +106,14 @@ public:
             return ptr_ != nullptr;
         }
 
-        T& operator*() const {
-            if (ptr_ == nullptr) {
-                throw std::logic_error("points to nullptr"s);
-            }
+        T& operator*() const noexcept(noexcept(CheckPolicy::Check(nullptr))) {
+            CheckPolicy::Check(ptr_);
             
             return *ptr_;
         }
 
-        T* operator->() const {
-            if (ptr_ == nullptr) {
-                throw std::logic_error("points to nullptr"s);
-            }
+        T* operator->() const noexcept(noexcept(CheckPolicy::Check(nullptr))) {
+            CheckPolicy::Check(ptr_);
             
             return ptr_;
         }
@@ -55,3 +121,8 @@ public:
 private:
     T* ptr_ = nullptr;
 };
+
+// Проверяет разыменование только в отладочной сборке,
+// в релизной сборке operator* и operator-> не добавляют накладных расходов
+template <typename T, typename Deleter = std::default_delete<T>>
+using DebugCheckedScopedPtr = ScopedPtr<T, Deleter, AssertNotNullCheck>;
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "log_duration.h"
+#include "scoped_pointer.h"
+
+using namespace std;
+
+// Суммирует элементы вектора, обращаясь к нему через умный указатель на каждой итерации
+template <typename Ptr>
+long long SumThroughPointer(const Ptr& ptr, int repeat_count) {
+    long long sum = 0;
+    for (int r = 0; r < repeat_count; ++r) {
+        for (size_t i = 0; i < ptr->size(); ++i) {
+            sum += (*ptr)[i];
+        }
+    }
+    return sum;
+}
+
+// Стоимость проверок политик разыменования ScopedPtr
+int main() {
+    const int repeat_count = 2000;
+    const vector<int> data(100000, 1);
+
+    long long checked_sum = 0;
+    long long debug_checked_sum = 0;
+    long long unchecked_sum = 0;
+    {
+        ScopedPtr<vector<int>> ptr(new vector<int>(data));
+        LOG_DURATION("ThrowOnNullCheck"s);
+        checked_sum = SumThroughPointer(ptr, repeat_count);
+    }
+    {
+        DebugCheckedScopedPtr<vector<int>> ptr(new vector<int>(data));
+        LOG_DURATION("AssertNotNullCheck"s);
+        debug_checked_sum = SumThroughPointer(ptr, repeat_count);
+    }
+    {
+        ScopedPtr<vector<int>, default_delete<vector<int>>, UncheckedAccess> ptr(new vector<int>(data));
+        LOG_DURATION("UncheckedAccess"s);
+        unchecked_sum = SumThroughPointer(ptr, repeat_count);
+    }
+
+    cerr << "Sums: "s << checked_sum << " "s << debug_checked_sum << " "s << unchecked_sum << endl;
+}
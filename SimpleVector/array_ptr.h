@@ -1,9 +1,70 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Выравнивания для ArrayPointer: по строке кэша (чтобы массивы разных потоков
+// не делили одну строку кэша) и по ширине векторных регистров AVX/AVX-512
+inline constexpr size_t kCacheLineAlignment = 64;
+inline constexpr size_t kAvxAlignment = 32;
+inline constexpr size_t kAvx512Alignment = 64;
+
+namespace array_ptr_detail {
+
+// Размер массива, нужный для освобождения выровненной памяти.
+// Для обычного массива он не нужен, и пустой базовый класс не занимает места
+template <bool kIsStored>
+class SizeHolder {
+public:
+    size_t GetStoredSize() const noexcept {
+        return size_;
+    }
+
+    void SetStoredSize(size_t size) noexcept {
+        size_ = size;
+    }
+
+    void SwapStoredSize(SizeHolder& other) noexcept {
+        std::swap(size_, other.size_);
+    }
+
+private:
+    size_t size_ = 0;
+};
+
+template <>
+class SizeHolder<false> {
+public:
+    size_t GetStoredSize() const noexcept {
+        return 0;
+    }
+
+    void SetStoredSize(size_t) noexcept {
+    }
+
+    void SwapStoredSize(SizeHolder&) noexcept {
+    }
+};
+
+} // namespace array_ptr_detail
+
+// Если kAlignment больше alignof(Type), память выделяется выровненным operator new[],
+// а размер блока округляется вверх до кратного kAlignment: тогда и последняя строка
+// кэша массива не делится с соседним блоком. В этом режиме Type должен иметь
+// тривиальный деструктор, а размер массива хранится для освобождения памяти
+template <typename Type, size_t kAlignment = alignof(Type)>
+class ArrayPointer : private array_ptr_detail::SizeHolder<(kAlignment > alignof(Type))> {
+    static_assert((kAlignment & (kAlignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(kAlignment >= alignof(Type), "alignment must not be weaker than alignof(Type)");
+
+    static constexpr bool kIsOverAligned = kAlignment > alignof(Type);
+    using SizeBase = array_ptr_detail::SizeHolder<kIsOverAligned>;
+
+    static_assert(!kIsOverAligned || std::is_trivially_destructible_v<Type>,
+                  "over-aligned ArrayPointer requires a trivially destructible type");
 
-template <typename Type>
-class ArrayPointer {
 public:
     ArrayPointer() = default;
 
@@ -11,25 +72,71 @@ public:
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
     explicit ArrayPointer(size_t size) {
         if (size == 0) return;
-        raw_ptr_ = new Type[size];
+        raw_ptr_ = Allocate(size);
+        SizeBase::SetStoredSize(size);
+    }
+
+    // raw_ptr должен быть получен из new Type[]. Для выровненного массива нужен размер,
+    // см. конструктор ниже
+    explicit ArrayPointer(Type* raw_ptr) noexcept: raw_ptr_(raw_ptr) {
+        static_assert(!kIsOverAligned, "over-aligned ArrayPointer needs the array size");
     }
 
-    explicit ArrayPointer(Type* raw_ptr) noexcept: raw_ptr_(raw_ptr) {}
+    // raw_ptr должен быть получен из Allocate(size)
+    ArrayPointer(Type* raw_ptr, size_t size) noexcept: raw_ptr_(raw_ptr) {
+        SizeBase::SetStoredSize(size);
+    }
 
     ArrayPointer(const ArrayPointer&) = delete;
 
     ~ArrayPointer() {
-        delete[] raw_ptr_;
+        Deallocate(raw_ptr_, SizeBase::GetStoredSize());
         raw_ptr_ = nullptr;
     }
 
     ArrayPointer& operator=(const ArrayPointer&) = delete;
 
+    // Размер в байтах блока под size элементов: для выровненного массива
+    // округляется вверх до кратного kAlignment
+    static constexpr size_t GetAllocationSize(size_t size) noexcept {
+        const size_t bytes = size * sizeof(Type);
+        return kIsOverAligned ? (bytes + kAlignment - 1) / kAlignment * kAlignment : bytes;
+    }
+
+    // Выделяет массив из size элементов с выравниванием kAlignment
+    static Type* Allocate(size_t size) {
+        if constexpr (kIsOverAligned) {
+            auto memory = static_cast<Type*>(::operator new[](GetAllocationSize(size), std::align_val_t{kAlignment}));
+            try {
+                std::uninitialized_default_construct_n(memory, size);
+                return memory;
+            } catch (...) {
+                ::operator delete[](memory, GetAllocationSize(size), std::align_val_t{kAlignment});
+                throw;
+            }
+        } else {
+            return new Type[size];
+        }
+    }
+
+    // Освобождает массив из size элементов, выделенный Allocate.
+    // Нужен для указателя, полученного из Release
+    static void Deallocate(Type* raw_ptr, [[maybe_unused]] size_t size) noexcept {
+        if constexpr (kIsOverAligned) {
+            if (raw_ptr != nullptr) {
+                ::operator delete[](raw_ptr, GetAllocationSize(size), std::align_val_t{kAlignment});
+            }
+        } else {
+            delete[] raw_ptr;
+        }
+    }
+
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
     // После вызова метода указатель на массив должен обнулиться
     [[nodiscard]] Type* Release() noexcept {
         auto temp = raw_ptr_;
         raw_ptr_ = nullptr;
+        SizeBase::SetStoredSize(0);
         return temp;
     }
 
@@ -53,6 +160,7 @@ public:
     // Обменивается значениям указателя на массив с объектом other
     void swap(ArrayPointer& other) noexcept {
         std::swap(raw_ptr_, other.raw_ptr_);
+        SizeBase::SwapStoredSize(other);
     }
 
 private:
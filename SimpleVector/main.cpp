@@ -1,3 +1,4 @@
+#include "mapped_array_ptr.h"
 #include "simple_vector.h"
 
 // Tests
@@ -18,6 +19,9 @@ int main() {
     TestNoncopiablePushBack();
     TestNoncopiableInsert();
     TestNoncopiableErase();
+    
+    TestArrayPointerAlignment();
+    TestMappedArrayPointer();
 //    
     return 0;
 }
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MapOptions {
+    // Заранее загрузить все страницы файла (MAP_POPULATE, только Linux).
+    // По умолчанию страницы подгружаются лениво при первом обращении
+    bool populate = false;
+};
+
+// Массив элементов Type, отображённый в память из файла (mmap).
+// Поверхность повторяет ArrayPointer: Get, operator[], Release, swap.
+// Содержимое массива переживает перезапуск программы, поэтому Type
+// должен быть тривиально копируемым.
+// MappedArrayPointer<const Type> отображает файл только для чтения: изменить
+// элементы или размер такого массива нельзя уже при компиляции
+template <typename Type>
+class MappedArrayPointer {
+    static_assert(std::is_trivially_copyable_v<Type>, "mapped array requires a trivially copyable type");
+
+    static constexpr bool kIsReadOnly = std::is_const_v<Type>;
+
+public:
+    MappedArrayPointer() = default;
+
+    // Создаёт (или перезаписывает) файл path размером size элементов и отображает его в память
+    static MappedArrayPointer Create(const std::string& path, size_t size, MapOptions options = {}) {
+        static_assert(!kIsReadOnly, "cannot create a file for a read-only mapping");
+        MappedArrayPointer result;
+        result.options_ = options;
+        result.fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (result.fd_ < 0) {
+            ThrowSystemError("open");
+        }
+        result.Resize(size);
+        return result;
+    }
+
+    // Открывает существующий файл path, размер массива определяется размером файла.
+    // Выбрасывает std::runtime_error, если размер файла не кратен sizeof(Type)
+    static MappedArrayPointer Open(const std::string& path, MapOptions options = {}) {
+        MappedArrayPointer result;
+        result.options_ = options;
+        result.fd_ = ::open(path.c_str(), kIsReadOnly ? O_RDONLY : O_RDWR);
+        if (result.fd_ < 0) {
+            ThrowSystemError("open");
+        }
+
+        struct stat file_stat {};
+        if (::fstat(result.fd_, &file_stat) != 0) {
+            ThrowSystemError("fstat");
+        }
+        const auto file_size = static_cast<size_t>(file_stat.st_size);
+        if (file_size % sizeof(Type) != 0) {
+            throw std::runtime_error("size of " + path + " is not a multiple of the element size");
+        }
+
+        const size_t size = file_size / sizeof(Type);
+        result.raw_ptr_ = result.Map(size);
+        result.size_ = size;
+        return result;
+    }
+
+    MappedArrayPointer(const MappedArrayPointer&) = delete;
+    MappedArrayPointer& operator=(const MappedArrayPointer&) = delete;
+
+    MappedArrayPointer(MappedArrayPointer&& other) noexcept {
+        swap(other);
+    }
+
+    MappedArrayPointer& operator=(MappedArrayPointer&& other) noexcept {
+        if (this != &other) {
+            MappedArrayPointer temp(std::move(other));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~MappedArrayPointer() {
+        Unmap(raw_ptr_, size_);
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    // Изменяет размер файла и заново отображает его. Адрес массива может измениться.
+    // При ошибке массив и файл сохраняют прежние размер и содержимое
+    void Resize(size_t new_size) {
+        static_assert(!kIsReadOnly, "cannot resize a read-only mapping");
+
+        // Отображение не должно выходить за конец файла, поэтому при росте файл
+        // увеличивается до отображения, а при уменьшении - урезается после него
+        Type* new_ptr = nullptr;
+        if (new_size > size_) {
+            Truncate(new_size);
+            try {
+                new_ptr = Map(new_size);
+            } catch (...) {
+                // Файл только дополнялся нулями, прежнее содержимое не тронуто
+                static_cast<void>(::ftruncate(fd_, static_cast<off_t>(size_ * sizeof(Type))));
+                throw;
+            }
+        } else {
+            new_ptr = Map(new_size);
+            try {
+                Truncate(new_size);
+            } catch (...) {
+                Unmap(new_ptr, new_size);
+                throw;
+            }
+        }
+
+        Unmap(raw_ptr_, size_);
+        raw_ptr_ = new_ptr;
+        size_ = new_size;
+    }
+
+    // Сбрасывает изменённые страницы в файл. При async == true не дожидается окончания записи
+    void Sync(bool async = false) const {
+        if (raw_ptr_ != nullptr && ::msync(ToVoidPointer(raw_ptr_), size_ * sizeof(Type), async ? MS_ASYNC : MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+    // Прекращает владение отображением и возвращает адрес массива.
+    // Вызывающий должен освободить его через munmap(ptr, GetSize() * sizeof(Type)),
+    // поэтому размер нужно запомнить до вызова
+    [[nodiscard]] Type* Release() noexcept {
+        auto temp = raw_ptr_;
+        raw_ptr_ = nullptr;
+        size_ = 0;
+        return temp;
+    }
+
+    Type& operator[](size_t index) noexcept {
+        return *(raw_ptr_ + index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return *(raw_ptr_ + index);
+    }
+
+    explicit operator bool() const {
+        return raw_ptr_ != nullptr;
+    }
+
+    Type* Get() const noexcept {
+        return raw_ptr_;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    void swap(MappedArrayPointer& other) noexcept {
+        std::swap(raw_ptr_, other.raw_ptr_);
+        std::swap(size_, other.size_);
+        std::swap(fd_, other.fd_);
+        std::swap(options_, other.options_);
+    }
+
+private:
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static void* ToVoidPointer(Type* ptr) noexcept {
+        return const_cast<std::remove_const_t<Type>*>(ptr);
+    }
+
+    void Truncate(size_t size) {
+        if (::ftruncate(fd_, static_cast<off_t>(size * sizeof(Type))) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+    }
+
+    // Отображает первые size элементов файла
+    Type* Map(size_t size) const {
+        // Отображение нулевой длины недопустимо, пустой массив хранит nullptr
+        if (size == 0) {
+            return nullptr;
+        }
+
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        if (options_.populate) {
+            flags |= MAP_POPULATE;
+        }
+#endif
+        const int protection = kIsReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+
+        void* memory = ::mmap(nullptr, size * sizeof(Type), protection, flags, fd_, 0);
+        if (memory == MAP_FAILED) {
+            ThrowSystemError("mmap");
+        }
+        return static_cast<Type*>(memory);
+    }
+
+    static void Unmap(Type* ptr, size_t size) noexcept {
+        if (ptr != nullptr) {
+            ::munmap(ToVoidPointer(ptr), size * sizeof(Type));
+        }
+    }
+
+private:
+    Type* raw_ptr_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+    MapOptions options_;
+};
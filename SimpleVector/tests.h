@@ -1,8 +1,11 @@
 #pragma once
 #include <cassert>
+#include <cstdint>
+#include <filesystem>
 #include <stdexcept>
 #include <iostream>
 #include <numeric>
+#include <type_traits>
 #include <utility>
 
 // У функции, объявленной со спецификатором inline, может быть несколько
@@ -585,3 +588,102 @@ void TestNoncopiableErase() {
     std::cout << "Done!" << std::endl << std::endl;
 }
 
+
+void TestArrayPointerAlignment() {
+    std::cout << "Test array pointer alignment" << std::endl;
+    {
+        ArrayPointer<float, kAvxAlignment> avx_array(7);
+        assert(reinterpret_cast<uintptr_t>(avx_array.Get()) % kAvxAlignment == 0);
+        // 28 байт округляются до 32, последняя строка кэша не делится с соседним блоком
+        static_assert(ArrayPointer<float, kAvxAlignment>::GetAllocationSize(7) == kAvxAlignment);
+
+        ArrayPointer<double, kCacheLineAlignment> cache_line_array(3);
+        assert(reinterpret_cast<uintptr_t>(cache_line_array.Get()) % kCacheLineAlignment == 0);
+        cache_line_array[2] = 1.5;
+        assert(cache_line_array[2] == 1.5);
+
+        ArrayPointer<double, kCacheLineAlignment> other_array(9);
+        static_assert(ArrayPointer<double, kCacheLineAlignment>::GetAllocationSize(9) == 2 * kCacheLineAlignment);
+        cache_line_array.swap(other_array);
+        assert(other_array[2] == 1.5);
+
+        // Освобождённый массив возвращается тем же выравнивающим аллокатором
+        // с тем же округлённым размером
+        double* raw_ptr = other_array.Release();
+        assert(!other_array);
+        ArrayPointer<double, kCacheLineAlignment>::Deallocate(raw_ptr, 3);
+        static_assert(ArrayPointer<double, kCacheLineAlignment>::GetAllocationSize(3) == kCacheLineAlignment);
+
+        ArrayPointer<int, kAvx512Alignment> empty_array(size_t{0});
+        assert(!empty_array);
+
+        // Массив, переданный владельцу по сырому указателю, освобождается с его размером
+        ArrayPointer<double, kCacheLineAlignment> adopted(ArrayPointer<double, kCacheLineAlignment>::Allocate(17), 17);
+        static_assert(ArrayPointer<double, kCacheLineAlignment>::GetAllocationSize(17) == 3 * kCacheLineAlignment);
+        static_assert(ArrayPointer<double, kCacheLineAlignment>::GetAllocationSize(16) == 2 * kCacheLineAlignment);
+    }
+    {
+        // После swap размер массива переходит к новому владельцу вместе с указателем.
+        // Размер, переданный в sized operator delete[], сверяет AddressSanitizer
+        ArrayPointer<double, kCacheLineAlignment> large_array(9);
+        {
+            ArrayPointer<double, kCacheLineAlignment> small_array(3);
+            small_array.swap(large_array);
+        }
+    }
+    // Размер массива хранится только для выровненного массива
+    static_assert(sizeof(ArrayPointer<int>) == sizeof(int*));
+    std::cout << "Done!" << std::endl << std::endl;
+}
+
+void TestMappedArrayPointer() {
+    std::cout << "Test mapped array pointer" << std::endl;
+    const std::string path = (std::filesystem::temp_directory_path() / "mapped_array_ptr_test.bin").string();
+    {
+        auto numbers = MappedArrayPointer<int>::Create(path, 4);
+        assert(numbers.GetSize() == 4);
+        for (int i = 0; i < 4; ++i) {
+            numbers[i] = i * 10;
+        }
+
+        numbers.Resize(6);
+        assert(numbers.GetSize() == 6);
+        assert(numbers[3] == 30);
+        numbers[5] = 50;
+        numbers.Sync();
+    }
+    {
+        // Содержимое сохраняется в файле между отображениями.
+        // Массив const-элементов отображается только для чтения
+        auto numbers = MappedArrayPointer<const int>::Open(path, {true});
+        static_assert(std::is_same_v<decltype(numbers[0]), const int&>);
+        assert(numbers.GetSize() == 6);
+        assert(numbers[0] == 0 && numbers[3] == 30 && numbers[5] == 50);
+
+        MappedArrayPointer<const int> other;
+        assert(!other);
+        other.swap(numbers);
+        assert(!numbers);
+        assert(other[5] == 50);
+    }
+    {
+        // При уменьшении и повторном росте сохраняется общая часть массива
+        auto numbers = MappedArrayPointer<int>::Open(path);
+        numbers.Resize(2);
+        assert(numbers.GetSize() == 2);
+        assert(std::filesystem::file_size(path) == 2 * sizeof(int));
+        numbers.Resize(3);
+        assert(numbers[0] == 0 && numbers[1] == 10 && numbers[2] == 0);
+    }
+    {
+        // Файл, размер которого не кратен размеру элемента, не отображается
+        std::filesystem::resize_file(path, 3 * sizeof(int) + 1);
+        try {
+            auto numbers = MappedArrayPointer<int>::Open(path);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+    }
+    std::filesystem::remove(path);
+    std::cout << "Done!" << std::endl << std::endl;
+}
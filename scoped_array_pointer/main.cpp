@@ -1,9 +1,70 @@
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Выравнивание по строке кэша и по ширине векторных регистров AVX/AVX-512
+inline constexpr size_t kCacheLineAlignment = 64;
+inline constexpr size_t kAvxAlignment = 32;
+inline constexpr size_t kAvx512Alignment = 64;
+
+namespace array_ptr_detail {
+
+// Размер массива, нужный для освобождения выровненной памяти.
+// Для обычного массива он не нужен, и пустой базовый класс не занимает места
+template <bool kIsStored>
+class SizeHolder {
+public:
+    size_t GetStoredSize() const noexcept {
+        return size_;
+    }
+
+    void SetStoredSize(size_t size) noexcept {
+        size_ = size;
+    }
+
+    void SwapStoredSize(SizeHolder& other) noexcept {
+        std::swap(size_, other.size_);
+    }
+
+private:
+    size_t size_ = 0;
+};
+
+template <>
+class SizeHolder<false> {
+public:
+    size_t GetStoredSize() const noexcept {
+        return 0;
+    }
+
+    void SetStoredSize(size_t) noexcept {
+    }
+
+    void SwapStoredSize(SizeHolder&) noexcept {
+    }
+};
+
+} // namespace array_ptr_detail
+
+// Если kAlignment больше alignof(Type), память выделяется выровненным operator new[],
+// а размер блока округляется вверх до кратного kAlignment: тогда и последняя строка
+// кэша массива не делится с соседним блоком. В этом режиме Type должен иметь
+// тривиальный деструктор, а размер массива хранится для освобождения памяти
+template <typename Type, size_t kAlignment = alignof(Type)>
+class ArrayPtr : private array_ptr_detail::SizeHolder<(kAlignment > alignof(Type))> {
+    static_assert((kAlignment & (kAlignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(kAlignment >= alignof(Type), "alignment must not be weaker than alignof(Type)");
+
+    static constexpr bool kIsOverAligned = kAlignment > alignof(Type);
+    using SizeBase = array_ptr_detail::SizeHolder<kIsOverAligned>;
+
+    static_assert(!kIsOverAligned || std::is_trivially_destructible_v<Type>,
+                  "over-aligned ArrayPtr requires a trivially destructible type");
 
-template <typename Type>
-class ArrayPtr {
 public:
     // Инициализирует ArrayPtr нулевым указателем
     ArrayPtr() = default;
@@ -12,30 +73,75 @@ public:
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
     explicit ArrayPtr(size_t size) {
         if (size == 0) return;
-        raw_ptr_ = new Type[size];
+        raw_ptr_ = Allocate(size);
+        SizeBase::SetStoredSize(size);
     }
 
-    // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
-    explicit ArrayPointer(Type* raw_ptr) noexcept: raw_ptr_(raw_ptr) {
+    // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr.
+    // Массив должен быть выделен через new Type[]. Для выровненного массива нужен размер,
+    // см. конструктор ниже
+    explicit ArrayPtr(Type* raw_ptr) noexcept: raw_ptr_(raw_ptr) {
 //        raw_ptr_ = raw_ptr;
+        static_assert(!kIsOverAligned, "over-aligned ArrayPtr needs the array size");
+    }
+
+    // Конструктор из массива, выделенного через Allocate(size)
+    ArrayPtr(Type* raw_ptr, size_t size) noexcept: raw_ptr_(raw_ptr) {
+        SizeBase::SetStoredSize(size);
     }
 
     // Запрещаем копирование
     ArrayPtr(const ArrayPtr&) = delete;
 
     ~ArrayPtr() {
-        delete [] raw_ptr_;
+        Deallocate(raw_ptr_, SizeBase::GetStoredSize());
         raw_ptr_ = nullptr;
     }
 
     // Запрещаем присваивание
     ArrayPtr& operator=(const ArrayPtr&) = delete;
 
+    // Размер в байтах блока под size элементов: для выровненного массива
+    // округляется вверх до кратного kAlignment
+    static constexpr size_t GetAllocationSize(size_t size) noexcept {
+        const size_t bytes = size * sizeof(Type);
+        return kIsOverAligned ? (bytes + kAlignment - 1) / kAlignment * kAlignment : bytes;
+    }
+
+    // Выделяет массив из size элементов с выравниванием kAlignment
+    static Type* Allocate(size_t size) {
+        if constexpr (kIsOverAligned) {
+            auto memory = static_cast<Type*>(::operator new[](GetAllocationSize(size), std::align_val_t{kAlignment}));
+            try {
+                std::uninitialized_default_construct_n(memory, size);
+                return memory;
+            } catch (...) {
+                ::operator delete[](memory, GetAllocationSize(size), std::align_val_t{kAlignment});
+                throw;
+            }
+        } else {
+            return new Type[size];
+        }
+    }
+
+    // Освобождает массив из size элементов, выделенный Allocate.
+    // Нужен для указателя, полученного из Release
+    static void Deallocate(Type* raw_ptr, [[maybe_unused]] size_t size) noexcept {
+        if constexpr (kIsOverAligned) {
+            if (raw_ptr != nullptr) {
+                ::operator delete[](raw_ptr, GetAllocationSize(size), std::align_val_t{kAlignment});
+            }
+        } else {
+            delete [] raw_ptr;
+        }
+    }
+
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
     // После вызова метода указатель на массив должен обнулиться
     [[nodiscard]] Type* Release() noexcept {
         auto temp = raw_ptr_;
         raw_ptr_ = nullptr;
+        SizeBase::SetStoredSize(0);
         return temp;
     }
 
@@ -62,6 +168,7 @@ public:
     // Обменивается значениям указателя на массив с объектом other
     void swap(ArrayPtr& other) noexcept {
         std::swap(raw_ptr_, other.raw_ptr_);
+        SizeBase::SwapStoredSize(other);
     }
 
 private:
@@ -85,4 +192,22 @@ int main() {
 
     assert(numbers_2[2] == 42);
     assert(numbers[2] == 43);
+
+    // Массивы для векторных вычислений выровнены по ширине регистров
+    ArrayPtr<float, kAvx512Alignment> floats(16);
+    assert(reinterpret_cast<uintptr_t>(floats.Get()) % kAvx512Alignment == 0);
+
+    // Массивы разных потоков не делят одну строку кэша
+    ArrayPtr<int, kCacheLineAlignment> counters(1);
+    assert(reinterpret_cast<uintptr_t>(counters.Get()) % kCacheLineAlignment == 0);
+
+    // Размер блока округляется до кратного выравниванию,
+    // поэтому и последняя строка кэша массива принадлежит только ему
+    static_assert(ArrayPtr<int, kCacheLineAlignment>::GetAllocationSize(1) == kCacheLineAlignment);
+    static_assert(ArrayPtr<float, kAvx512Alignment>::GetAllocationSize(17) == 2 * kAvx512Alignment);
+    static_assert(sizeof(ArrayPtr<int>) == sizeof(int*));
+
+    ArrayPtr<double, kAvxAlignment> released(4);
+    ArrayPtr<double, kAvxAlignment>::Deallocate(released.Release(), 4);
+    assert(!released);
 }